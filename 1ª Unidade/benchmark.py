@@ -0,0 +1,317 @@
+"""Benchmark das ordenações da 1ª Unidade sobre entradas geradas.
+
+Compila os programas, gera cada (distribuição, tamanho) com geradorEntradas.c e
+executa cada rotina num processo próprio, registrando vazão, comparações, trocas
+e pico de memória. As tabelas marcam com * o melhor valor de cada coluna e a
+linha "vencedor" mostra onde o melhor método muda com o tamanho. Com
+--referencia, compara a vazão com um CSV salvo antes por --csv.
+
+Exemplo:
+    python3 benchmark.py --tamanhos=1000,100000,1000000 --csv=atual.csv
+    python3 benchmark.py --tamanhos=1000,100000,1000000 --referencia=atual.csv
+"""
+
+import argparse
+import csv
+import io
+import math
+import os
+import statistics
+import subprocess
+import sys
+
+DIRETORIO = os.path.dirname(os.path.abspath(__file__))
+
+DISTRIBUICOES = ["uniforme", "ordenado", "reverso", "orgao", "serra", "poucos", "zipf", "antiqsort"]
+
+# Métodos de evertonlucas_202400017737_quicksort.c, na ordem dos códigos
+METODOS_QUICKSORT = ["LP", "LM", "LA", "HP", "HM", "HA", "BM", "BA", "TV", "DP", "VM", "PD",
+                     "LR", "LN", "LS", "LD", "HR", "HN", "HS", "HD",
+                     "BR", "BN", "BS", "BD", "TR", "TN", "TS", "TD", "DR", "DN", "DS", "DD"]
+
+# Programas compilados: nome do executável, fonte e bibliotecas
+PROGRAMAS = {
+    "quicksort": ("evertonlucas_202400017737_quicksort.c", ["-lpthread", "-lm"]),
+    "quickSort": ("quickSort.c", []),
+    "heapSort": ("heapSort.c", []),
+    "mergeSort": ("mergeSort.c", ["-lpthread"]),
+    "gerador": ("geradorEntradas.c", ["-lm"]),
+}
+
+# Métricas das tabelas: título, função do valor e se o maior valor é o melhor
+METRICAS = {
+    "vazao": ("vazão (milhões de elementos/s)",
+              lambda r: r["tamanho"] / r["ns"] * 1e3 if r["ns"] else None, True),
+    "comparacoes": ("comparações / (n log2 n)",
+                    lambda r: r["comparacoes"] / (r["tamanho"] * math.log2(r["tamanho"]))
+                    if r["comparacoes"] is not None and r["tamanho"] > 1 else None, False),
+    "trocas": ("trocas / n",
+               lambda r: r["trocas"] / r["tamanho"] if r["trocas"] is not None and r["tamanho"] else None, False),
+    "memoria": ("pico de memória (MB)",
+                lambda r: r["memoria_kb"] / 1024 if r["memoria_kb"] is not None else None, False),
+}
+
+
+def compilar(pasta_bin, cc, cflags):
+    """Compila os programas em pasta_bin; retorna o caminho de cada executável."""
+    os.makedirs(pasta_bin, exist_ok=True)
+    executaveis = {}
+    for nome, (fonte, bibliotecas) in PROGRAMAS.items():
+        destino = os.path.join(pasta_bin, nome)
+        comando = [cc] + cflags + ["-o", destino, os.path.join(DIRETORIO, fonte)] + bibliotecas
+        resultado = subprocess.run(comando, capture_output=True, text=True)
+        if resultado.returncode != 0:
+            sys.exit(f"Erro ao compilar {fonte}:\n{resultado.stderr}")
+        executaveis[nome] = destino
+    return executaveis
+
+
+def listar_rotinas(executaveis, pasta, metodos, threads):
+    """Monta as rotinas: nome, formato da entrada e função que gera o comando.
+
+    Cada comando devolve (argumentos, arquivo de métricas ou None); sem arquivo,
+    as métricas vêm em CSV pela saída padrão.
+    """
+    metricas = os.path.join(pasta, "metricas.csv")
+    saida = os.path.join(pasta, "saida.txt")
+    rotinas = []
+    for m in metodos:
+        rotinas.append((f"quicksort/{m}", "binario",
+                        lambda e, m=m: ([executaveis["quicksort"], e, saida, f"--metodos={m}", "--threads=1",
+                                         f"--metricas-csv={metricas}"], metricas)))
+    rotinas.append(("quicksort/HM-paralelo", "binario",
+                    lambda e: ([executaveis["quicksort"], e, saida, "--metodos=HM", "--paralelo",
+                                f"--threads={threads}", f"--metricas-csv={metricas}"], metricas)))
+    for codigo, m in enumerate(["LP", "LM", "LA", "HP", "HM", "HA"], start=1):
+        rotinas.append((f"quickSort.c/{m}", "texto",
+                        lambda e, c=codigo: ([executaveis["quickSort"], e, str(c)], None)))
+    rotinas.append(("heapSort.c", "texto", lambda e: ([executaveis["heapSort"], e], None)))
+    for impl in ["classico", "generico", "paralelo"]:
+        rotinas.append((f"mergeSort.c/{impl}", "texto",
+                        lambda e, i=impl: ([executaveis["mergeSort"], e, i, str(threads)], None)))
+    return rotinas
+
+
+def executar(comando, tempo_limite):
+    """Executa o comando com tempo limite.
+
+    Retorna (código de saída ou None se estourou o tempo, saída padrão).
+    """
+    try:
+        resultado = subprocess.run(comando, stdout=subprocess.PIPE, stderr=subprocess.DEVNULL, text=True,
+                                   timeout=tempo_limite)
+    except subprocess.TimeoutExpired:
+        return None, ""
+    return resultado.returncode, resultado.stdout
+
+
+def inteiro_ou_none(texto):
+    """Converte um campo de CSV em inteiro (campo vazio = indisponível)."""
+    return int(texto) if texto not in (None, "") else None
+
+
+def ler_metricas(texto):
+    """Lê a primeira linha de métricas (quicksort ou demos) de um CSV.
+
+    O pico de memória é o VmHWM que o próprio programa informa: o ru_maxrss do
+    wait4 herda o pico do Python que criou o filho e não serve para entradas pequenas.
+    """
+    for linha in csv.DictReader(io.StringIO(texto)):
+        return (inteiro_ou_none(linha["ns"]), inteiro_ou_none(linha["comparacoes"]),
+                inteiro_ou_none(linha["trocas"]), inteiro_ou_none(linha.get("memoria_kb")))
+    return None
+
+
+def medir(rotina, entrada, tamanho, args):
+    """Mede uma rotina numa entrada com args.repeticoes execuções (mediana do tempo)."""
+    nome, _, montar = rotina
+    tempos, comparacoes, trocas, memoria = [], None, None, None
+    for _ in range(args.repeticoes):
+        comando, arquivo_metricas = montar(entrada)
+        if arquivo_metricas and os.path.exists(arquivo_metricas):
+            os.remove(arquivo_metricas)
+        codigo, saida = executar(comando, args.tempo_limite)
+        if codigo is None:
+            return {"rotina": nome, "tamanho": tamanho, "estado": "tempo"}
+        if arquivo_metricas and codigo == 0 and os.path.exists(arquivo_metricas):
+            with open(arquivo_metricas, encoding="utf-8") as f:
+                saida = f.read()
+        lidas = ler_metricas(saida) if codigo == 0 else None
+        if lidas is None or lidas[0] is None:
+            return {"rotina": nome, "tamanho": tamanho, "estado": "falha"}
+        tempos.append(lidas[0])
+        comparacoes, trocas = lidas[1], lidas[2]
+        if lidas[3] is not None:
+            memoria = max(memoria or 0, lidas[3])
+    return {"rotina": nome, "tamanho": tamanho, "estado": "ok", "ns": int(statistics.median(tempos)),
+            "comparacoes": comparacoes, "trocas": trocas, "memoria_kb": memoria}
+
+
+def gerar(executaveis, pasta, distribuicao, tamanho, com_texto, args):
+    """Gera a entrada binária e, se com_texto, a converte para texto (o antiqsort custa
+    uma ordenação quadrática, então é gerado uma vez só). Retorna {formato: caminho ou None}.
+    """
+    binario = os.path.join(pasta, f"{distribuicao}_{tamanho}.bin")
+    texto = os.path.join(pasta, f"{distribuicao}_{tamanho}.txt")
+    comando = [executaveis["gerador"], binario, distribuicao, str(tamanho), f"--semente={args.semente}",
+               "--formato=binario", f"--vitima={args.vitima}"]
+    if executar(comando, args.tempo_limite)[0] != 0:
+        return {"binario": None, "texto": None}
+    if not com_texto:
+        return {"binario": binario, "texto": None}
+    comando = [executaveis["quicksort"], binario, texto, "--converter=texto"]
+    convertido = executar(comando, args.tempo_limite)[0] == 0
+    return {"binario": binario, "texto": texto if convertido else None}
+
+
+def formatar(valor):
+    """Formata um valor de tabela com 3 algarismos significativos."""
+    if valor is None:
+        return "-"
+    if valor == 0 or abs(valor) >= 100:
+        return f"{valor:.0f}"
+    return f"{valor:.3g}"
+
+
+def imprimir_tabela(titulo, rotinas, tamanhos, celulas, maior_melhor):
+    """Imprime uma tabela rotina x tamanho marcando o melhor valor de cada coluna."""
+    melhores = {}
+    for t in tamanhos:
+        valores = [(v, r) for r in rotinas if isinstance(v := celulas.get((r, t)), (int, float))]
+        if valores:
+            melhores[t] = (max if maior_melhor else min)(valores)[1]
+    largura = max([len(r) for r in rotinas] + [8])
+    print(f"\n{titulo}")
+    print(f"{'rotina':<{largura}}" + "".join(f"{t:>14}" for t in tamanhos))
+    for r in rotinas:
+        linha = f"{r:<{largura}}"
+        for t in tamanhos:
+            valor = celulas.get((r, t))
+            texto = valor if isinstance(valor, str) else formatar(valor)
+            linha += f"{texto + ('*' if melhores.get(t) == r else ' '):>14}"
+        print(linha)
+    return melhores
+
+
+def imprimir_relatorio(resultados, referencia, args):
+    """Imprime as tabelas de cada distribuição e, com referência, a razão de vazão."""
+    for distribuicao in args.distribuicoes:
+        linhas = [r for r in resultados if r["distribuicao"] == distribuicao]
+        if not linhas:
+            continue
+        rotinas = list(dict.fromkeys(r["rotina"] for r in linhas))
+        tamanhos = sorted({r["tamanho"] for r in linhas})
+        print(f"\n===== {distribuicao} =====")
+        for metrica in args.metricas:
+            titulo, valor, maior_melhor = METRICAS[metrica]
+            celulas = {(r["rotina"], r["tamanho"]): valor(r) if r["estado"] == "ok" else r["estado"]
+                       for r in linhas}
+            melhores = imprimir_tabela(titulo, rotinas, tamanhos, celulas, maior_melhor)
+            if metrica == "vazao":
+                print("vencedor: " + ", ".join(f"{t}={melhores[t]}" for t in tamanhos if t in melhores))
+
+        # Razão da vazão atual sobre a de referência; ! marca queda além da tolerância
+        if referencia:
+            celulas = {}
+            for r in linhas:
+                antigo = referencia.get((distribuicao, r["rotina"], r["tamanho"]))
+                if r["estado"] == "ok" and antigo and antigo.get("ns"):
+                    razao = antigo["ns"] / r["ns"]
+                    celulas[(r["rotina"], r["tamanho"])] = formatar(razao) + ("!" if razao < 1 - args.tolerancia else "")
+            if celulas:
+                imprimir_tabela("vazão atual / referência (! = regressão)", rotinas, tamanhos, celulas, True)
+
+
+CAMPOS_CSV = ["distribuicao", "tamanho", "rotina", "estado", "ns", "comparacoes", "trocas", "memoria_kb"]
+
+
+def salvar_csv(caminho, resultados):
+    """Grava os resultados brutos em CSV (entrada de --referencia)."""
+    with open(caminho, "w", newline="", encoding="utf-8") as f:
+        escritor = csv.DictWriter(f, fieldnames=CAMPOS_CSV, extrasaction="ignore")
+        escritor.writeheader()
+        escritor.writerows(resultados)
+
+
+def ler_referencia(caminho):
+    """Lê um CSV de --csv indexado por (distribuição, rotina, tamanho)."""
+    referencia = {}
+    with open(caminho, encoding="utf-8") as f:
+        for linha in csv.DictReader(f):
+            if linha["estado"] == "ok":
+                referencia[(linha["distribuicao"], linha["rotina"], int(linha["tamanho"]))] = {
+                    "ns": inteiro_ou_none(linha["ns"])}
+    return referencia
+
+
+def lista(texto, validos=None):
+    """Converte "a,b,c" numa lista, conferindo os valores permitidos."""
+    itens = [i for i in texto.split(",") if i]
+    if validos is not None:
+        for i in itens:
+            if i not in validos:
+                raise argparse.ArgumentTypeError(f"valor inválido: {i}")
+    return itens
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--tamanhos", type=lambda t: [int(float(x)) for x in lista(t)],
+                        default=[10, 1000, 100000],
+                        help="elementos por entrada, de 10 a 10^9 (aceita 1e6; padrão: 10,1000,100000)")
+    parser.add_argument("--distribuicoes", type=lambda t: lista(t, DISTRIBUICOES), default=DISTRIBUICOES,
+                        help="distribuições (padrão: todas)")
+    parser.add_argument("--metodos", type=lambda t: lista(t, METODOS_QUICKSORT), default=METODOS_QUICKSORT,
+                        help="métodos do quicksort principal (padrão: todos)")
+    parser.add_argument("--rotinas", type=lista, default=None,
+                        help="prefixos das rotinas medidas, como quicksort/H,heapSort.c (padrão: todas)")
+    parser.add_argument("--metricas", type=lambda t: lista(t, METRICAS), default=list(METRICAS),
+                        help="tabelas impressas: vazao,comparacoes,trocas,memoria (padrão: todas)")
+    parser.add_argument("--repeticoes", type=int, default=1, help="execuções por medição (mediana do tempo)")
+    parser.add_argument("--tempo-limite", type=float, default=60, help="segundos por execução (padrão: 60)")
+    parser.add_argument("--threads", type=int, default=4, help="threads das rotinas paralelas (padrão: 4)")
+    parser.add_argument("--semente", type=int, default=42, help="semente das entradas (padrão: 42)")
+    parser.add_argument("--vitima", default="HM", help="método atacado pelo antiqsort (padrão: HM)")
+    parser.add_argument("--pasta", default=os.path.join(DIRETORIO, "_benchmark"),
+                        help="pasta dos executáveis e das entradas geradas")
+    parser.add_argument("--csv", help="grava os resultados brutos neste arquivo")
+    parser.add_argument("--referencia", help="CSV de uma execução anterior para comparar a vazão")
+    parser.add_argument("--tolerancia", type=float, default=0.1,
+                        help="queda relativa de vazão que conta como regressão (padrão: 0.1)")
+    args = parser.parse_args()
+
+    cc = os.environ.get("CC", "gcc")
+    cflags = os.environ.get("CFLAGS", "-O2").split()
+    executaveis = compilar(os.path.join(args.pasta, "bin"), cc, cflags)
+    rotinas = listar_rotinas(executaveis, args.pasta, args.metodos, args.threads)
+    if args.rotinas:
+        rotinas = [r for r in rotinas if any(r[0].startswith(p) for p in args.rotinas)]
+    referencia = ler_referencia(args.referencia) if args.referencia else None
+
+    resultados = []
+    for distribuicao in args.distribuicoes:
+        for tamanho in args.tamanhos:
+            # As entradas de cada tamanho são apagadas ao fim dele
+            entradas = gerar(executaveis, args.pasta, distribuicao, tamanho,
+                             any(r[1] == "texto" for r in rotinas), args)
+            for rotina in rotinas:
+                entrada = entradas[rotina[1]]
+                if entrada is None:
+                    resultado = {"rotina": rotina[0], "tamanho": tamanho, "estado": "sem entrada"}
+                else:
+                    resultado = medir(rotina, entrada, tamanho, args)
+                resultado["distribuicao"] = distribuicao
+                resultados.append(resultado)
+                print(f"{distribuicao:>10} {tamanho:>10} {rotina[0]:<24} {resultado['estado']}",
+                      file=sys.stderr)
+            for entrada in entradas.values():
+                if entrada and os.path.exists(entrada):
+                    os.remove(entrada)
+
+    if args.csv:
+        salvar_csv(args.csv, resultados)
+    imprimir_relatorio(resultados, referencia, args)
+
+
+if __name__ == "__main__":
+    main()
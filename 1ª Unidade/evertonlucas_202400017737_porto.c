@@ -2,240 +2,1908 @@
 #include <string.h>
 #include <stdlib.h>
 #include <math.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <time.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "mergeSortGenerico.h"
 
 #define MAX_CNPJ_LENGTH 32
 #define MAX_CODE_LENGTH 32
 
-typedef struct
-{
-    char codigo[MAX_CODE_LENGTH];
-    char cnpj[MAX_CNPJ_LENGTH];
-    int peso;
-    int qtd;
-    int temDivergenciaCNPJ;
-} Container;
+// Códigos ISO 6346 (4 letras + 7 dígitos) e CNPJs (14 dígitos) cabem em inteiros de 64 bits
+#define DIGITOS_CODIGO 10000000ULL
 
+// Manifesto em layout de estrutura de arrays: cada campo em um vetor contíguo
 typedef struct
 {
-    Container *containers;
+    uint64_t *codigos;
+    uint64_t *cnpjs;
+    int *pesos;
+    unsigned char *temDivergenciaCNPJ;
     int qtd;
 } ContainerArray;
 
-// Função para ler os dados dos contêineres do arquivo
-ContainerArray lerDados(FILE* arquivo)
+// Função para compactar um código ISO 6346 preservando a ordem lexicográfica
+int codificarCodigo(const char *texto, uint64_t *chave)
+{
+    uint64_t letras = 0, digitos = 0;
+    // Quatro letras maiúsculas em base 26
+    for (int k = 0; k < 4; k++)
+    {
+        if (texto[k] < 'A' || texto[k] > 'Z') return 0;
+        letras = letras * 26 + (uint64_t)(texto[k] - 'A');
+    }
+    // Sete dígitos decimais
+    for (int k = 4; k < 11; k++)
+    {
+        if (texto[k] < '0' || texto[k] > '9') return 0;
+        digitos = digitos * 10 + (uint64_t)(texto[k] - '0');
+    }
+    // O código deve terminar exatamente após o último dígito
+    if (texto[11] != '\0') return 0;
+    *chave = letras * DIGITOS_CODIGO + digitos;
+    return 1;
+}
+
+// Procedimento para formatar um código compactado de volta para texto
+void decodificarCodigo(uint64_t chave, char texto[12])
+{
+    uint64_t letras = chave / DIGITOS_CODIGO;
+    uint64_t digitos = chave % DIGITOS_CODIGO;
+    // Dígitos da direita para a esquerda
+    for (int k = 10; k >= 4; k--)
+    {
+        texto[k] = (char)('0' + digitos % 10);
+        digitos /= 10;
+    }
+    // Letras da direita para a esquerda
+    for (int k = 3; k >= 0; k--)
+    {
+        texto[k] = (char)('A' + letras % 26);
+        letras /= 26;
+    }
+    texto[11] = '\0';
+}
+
+// Função para compactar um CNPJ no formato XX.XXX.XXX/XXXX-XX
+int codificarCNPJ(const char *texto, uint64_t *chave)
+{
+    // Máscara da pontuação esperada ('#' indica dígito)
+    const char *mascara = "##.###.###/####-##";
+    uint64_t valor = 0;
+    int k;
+    for (k = 0; mascara[k]; k++)
+    {
+        if (mascara[k] == '#')
+        {
+            if (texto[k] < '0' || texto[k] > '9') return 0;
+            valor = valor * 10 + (uint64_t)(texto[k] - '0');
+        }
+        else if (texto[k] != mascara[k]) return 0;
+    }
+    // O CNPJ deve terminar junto com a máscara
+    if (texto[k] != '\0') return 0;
+    *chave = valor;
+    return 1;
+}
+
+// Procedimento para formatar um CNPJ compactado de volta para texto
+void decodificarCNPJ(uint64_t chave, char texto[19])
+{
+    const char *mascara = "##.###.###/####-##";
+    // Preenche os dígitos da direita para a esquerda
+    for (int k = 17; k >= 0; k--)
+    {
+        if (mascara[k] == '#')
+        {
+            texto[k] = (char)('0' + chave % 10);
+            chave /= 10;
+        }
+        else texto[k] = mascara[k];
+    }
+    texto[18] = '\0';
+}
+
+// Procedimento para liberar os vetores de um manifesto
+void liberarContainers(ContainerArray *arr)
+{
+    free(arr->codigos);
+    free(arr->cnpjs);
+    free(arr->pesos);
+    free(arr->temDivergenciaCNPJ);
+    arr->codigos = arr->cnpjs = NULL;
+    arr->pesos = NULL;
+    arr->temDivergenciaCNPJ = NULL;
+    arr->qtd = 0;
+}
+
+// Função para alocar um manifesto vazio com n containers
+ContainerArray alocarContainers(int n)
+{
+    ContainerArray resultado = {NULL, NULL, NULL, NULL, 0};
+    size_t qtd = n > 0 ? (size_t)n : 1;
+    resultado.codigos = malloc(sizeof(uint64_t) * qtd);
+    resultado.cnpjs = malloc(sizeof(uint64_t) * qtd);
+    resultado.pesos = malloc(sizeof(int) * qtd);
+    resultado.temDivergenciaCNPJ = calloc(qtd, sizeof(unsigned char));
+    // Desfaz a alocação parcial em caso de falha
+    if (!resultado.codigos || !resultado.cnpjs || !resultado.pesos || !resultado.temDivergenciaCNPJ)
+    {
+        liberarContainers(&resultado);
+        return resultado;
+    }
+    resultado.qtd = n;
+    return resultado;
+}
+
+// Função para ler os dados dos contêineres do arquivo; registros com código ou CNPJ
+// fora do formato são descartados com aviso (contados em rejeitados) e a leitura
+// continua. Cabeçalho inválido, arquivo truncado ou falta de memória devolvem
+// codigos == NULL, que não se confunde com um manifesto vazio
+ContainerArray lerDados(FILE* arquivo, int *rejeitados)
 {
     // Inicializa o array de containers
-    ContainerArray resultado = {NULL, 0};
+    ContainerArray resultado = {NULL, NULL, NULL, NULL, 0};
     // Lê a quantidade de containers
     int n;
+    *rejeitados = 0;
 
-    fscanf(arquivo, "%d", &n); // Lê o número de containers
+    // Lê o número de containers
+    if (fscanf(arquivo, "%d", &n) != 1 || n < 0)
+    {
+        fprintf(stderr, "Cabeçalho do manifesto inválido.\n");
+        return resultado;
+    }
 
     // Alocação dinâmica de memória para os containers
-    Container *dadosContainer = malloc(sizeof(Container) * n);
+    resultado = alocarContainers(n);
     // Verifica se a alocação foi bem-sucedida
-    if (!dadosContainer)
+    if (!resultado.codigos)
     {
         printf("Erro de alocação.\n");
         return resultado;
     }
 
     // Leitura dos dados dos containers
+    char codigo[MAX_CODE_LENGTH], cnpj[MAX_CNPJ_LENGTH];
+    int qtd = 0;
     for (int i = 0; i < n; ++i)
     {
-        // Realiza a leitura e verifica se foi bem-sucedida
-        fscanf(arquivo, "%s %s %d", dadosContainer[i].codigo, dadosContainer[i].cnpj, &dadosContainer[i].peso);
+        // Realiza a leitura; sem os três campos o arquivo está truncado
+        if (fscanf(arquivo, "%31s %31s %d", codigo, cnpj, &resultado.pesos[qtd]) != 3)
+        {
+            fprintf(stderr, "Registro de container incompleto (%d).\n", i + 1);
+            liberarContainers(&resultado);
+            return resultado;
+        }
+        // Compacta os campos textuais; um registro fora do formato não entra na auditoria
+        if (!codificarCodigo(codigo, &resultado.codigos[qtd]) || !codificarCNPJ(cnpj, &resultado.cnpjs[qtd]))
+        {
+            fprintf(stderr, "Registro de container inválido ignorado (%d): %s %s\n", i + 1, codigo, cnpj);
+            (*rejeitados)++;
+            continue;
+        }
+        qtd++;
     }
-    // Inicializa o campo de divergência de CNPJ
-    for (int i = 0; i < n; ++i)
-        dadosContainer[i].temDivergenciaCNPJ = 0;
+    resultado.qtd = qtd;
 
-    // Adiciona os dados da lista de containers lidos ao resultado
-    resultado.containers = dadosContainer;
-    // Define a quantidade de containers lidos
-    resultado.qtd = n;
     // Retorna o array de containers lidos
     return resultado;
 }
 
-// Procedimento de mergesort
-void mergeContainers(Container *arr, Container *tmp, int l, int m, int r)
+// Algoritmos disponíveis para ordenar o manifesto observado
+typedef enum
+{
+    ORDENACAO_RADIX,
+    ORDENACAO_MERGE
+} TipoOrdenacao;
+
+// Radix sort LSD com dígitos de 11 bits: 4 passadas cobrem os 43 bits de um código ISO 6346
+#define BITS_RADIX 11
+#define BALDES_RADIX (1 << BITS_RADIX)
+// Abaixo desse tamanho o custo de criar threads supera o ganho
+#define MIN_POR_THREAD_RADIX (1 << 16)
+
+// Par (chave, índice) ordenado no lugar do registro completo
+typedef struct
+{
+    uint64_t chave;
+    uint32_t indice;
+} ParChave;
+
+// Merge sort genérico sobre os pares, estável como o radix sort
+#define MENOR_PAR(a, b) ((a).chave < (b).chave)
+DEFINIR_MERGESORT(mergesortPares, ParChave, MENOR_PAR)
+
+// Portão de largada: as threads auxiliares só começam a trabalhar depois que todas as
+// criações foram tentadas, para que o particionamento e a barreira usem o número de
+// threads que de fato existem
+typedef struct
+{
+    pthread_mutex_t trava;
+    pthread_cond_t sinal;
+    int aberto;
+} Largada;
+
+void iniciarLargada(Largada *l)
+{
+    pthread_mutex_init(&l->trava, NULL);
+    pthread_cond_init(&l->sinal, NULL);
+    l->aberto = 0;
+}
+
+void aguardarLargada(Largada *l)
+{
+    pthread_mutex_lock(&l->trava);
+    while (!l->aberto) pthread_cond_wait(&l->sinal, &l->trava);
+    pthread_mutex_unlock(&l->trava);
+}
+
+void abrirLargada(Largada *l)
+{
+    pthread_mutex_lock(&l->trava);
+    l->aberto = 1;
+    pthread_cond_broadcast(&l->sinal);
+    pthread_mutex_unlock(&l->trava);
+}
+
+void destruirLargada(Largada *l)
+{
+    pthread_mutex_destroy(&l->trava);
+    pthread_cond_destroy(&l->sinal);
+}
+
+// Função que cria as threads auxiliares 1..threads-1 (a tarefa t fica em tarefas + t * tamanho);
+// para na primeira falha e retorna quantas threads participam, contando a atual
+int criarAuxiliares(pthread_t *ids, int threads, void *(*rotina)(void *), void *tarefas, size_t tamanho)
 {
-    // Índices iniciais para as duas metades e para o array temporário
-    int i = l;
-    int j = m + 1;
-    int k = 0;
+    int criadas = 1;
+    while (criadas < threads && pthread_create(&ids[criadas], NULL, rotina, (char *)tarefas + tamanho * (size_t)criadas) == 0)
+        criadas++;
+    if (criadas < threads)
+        fprintf(stderr, "Aviso: apenas %d de %d threads puderam ser criadas.\n", criadas, threads);
+    return criadas;
+}
+
+// Estado compartilhado entre as threads do radix sort
+typedef struct
+{
+    ParChave *origem;
+    ParChave *destino;
+    int n;
+    int threads;
+    int passadas;
+    size_t (*histogramas)[BALDES_RADIX];
+    pthread_barrier_t barreira;
+    Largada largada;
+} RadixCompartilhado;
+
+// Argumento de cada thread do radix sort
+typedef struct
+{
+    RadixCompartilhado *comp;
+    int id;
+} RadixTarefa;
 
-    // Mescla as duas metades em ordem
-    while (i <= m && j <= r)
+// Procedimento executado por cada thread: histograma local, prefixo global e espalhamento paralelo
+void *radixTrabalhador(void *arg)
+{
+    RadixTarefa *tarefa = arg;
+    RadixCompartilhado *comp = tarefa->comp;
+    aguardarLargada(&comp->largada);
+    // Bloco contíguo de pares sob responsabilidade desta thread
+    int inicio = (int)((int64_t)comp->n * tarefa->id / comp->threads);
+    int fim = (int)((int64_t)comp->n * (tarefa->id + 1) / comp->threads);
+    size_t *hist = comp->histogramas[tarefa->id];
+    ParChave *origem = comp->origem;
+    ParChave *destino = comp->destino;
+
+    for (int p = 0; p < comp->passadas; p++)
     {
-        // Compara os códigos dos containers para ordenação
-        if (strcmp(arr[i].codigo, arr[j].codigo) <= 0)
+        int deslocamento = p * BITS_RADIX;
+        // Conta as ocorrências de cada dígito no bloco local
+        memset(hist, 0, sizeof(size_t) * BALDES_RADIX);
+        for (int i = inicio; i < fim; i++)
+            hist[(origem[i].chave >> deslocamento) & (BALDES_RADIX - 1)]++;
+        pthread_barrier_wait(&comp->barreira);
+
+        // Uma única thread converte os histogramas em posições iniciais (dígito, depois thread: mantém a estabilidade)
+        if (tarefa->id == 0)
         {
-            // Se o código do container da primeira metade for menor ou igual, copia para o array temporário
-            tmp[k++] = arr[i++];
-        } else {
-            // Caso o codigo do container da segunda metade seja menor, copia para o array temporário
-            tmp[k++] = arr[j++];
+            size_t soma = 0;
+            for (int d = 0; d < BALDES_RADIX; d++)
+                for (int t = 0; t < comp->threads; t++)
+                {
+                    size_t qtd = comp->histogramas[t][d];
+                    comp->histogramas[t][d] = soma;
+                    soma += qtd;
+                }
         }
+        pthread_barrier_wait(&comp->barreira);
+
+        // Espalha os pares do bloco local nas posições reservadas
+        for (int i = inicio; i < fim; i++)
+            destino[hist[(origem[i].chave >> deslocamento) & (BALDES_RADIX - 1)]++] = origem[i];
+        pthread_barrier_wait(&comp->barreira);
+
+        // Troca os papéis dos vetores para a próxima passada
+        ParChave *aux = origem;
+        origem = destino;
+        destino = aux;
     }
-    // Copia os elementos restantes de ambas as metades, se houver
-    while (i <= m) tmp[k++] = arr[i++];
-    while (j <= r) tmp[k++] = arr[j++];
+    return NULL;
+}
 
-    // Copia os elementos do array temporário de volta para o array original
-    for (int t = 0; t < k; ++t)
+// Função de radix sort paralelo e estável; retorna o vetor (pares ou tmp) que contém o resultado
+ParChave *radixSortPares(ParChave *pares, ParChave *tmp, int n, int threads)
+{
+    // Descobre quantas passadas de 11 bits a maior chave exige
+    uint64_t maior = 0;
+    for (int i = 0; i < n; i++)
+        if (pares[i].chave > maior) maior = pares[i].chave;
+    int passadas = 0;
+    while (passadas * BITS_RADIX < 64 && (maior >> (passadas * BITS_RADIX)) != 0) passadas++;
+
+    // Limita as threads para que cada uma tenha trabalho suficiente
+    if (threads > n / MIN_POR_THREAD_RADIX) threads = n / MIN_POR_THREAD_RADIX;
+    if (threads < 1) threads = 1;
+
+    RadixCompartilhado comp;
+    comp.origem = pares;
+    comp.destino = tmp;
+    comp.n = n;
+    comp.threads = threads;
+    comp.passadas = passadas;
+    comp.histogramas = malloc(sizeof(*comp.histogramas) * threads);
+    RadixTarefa *tarefas = malloc(sizeof(RadixTarefa) * threads);
+    pthread_t *ids = malloc(sizeof(pthread_t) * threads);
+    if (!comp.histogramas || !tarefas || !ids)
+    {
+        free(comp.histogramas); free(tarefas); free(ids);
+        return NULL;
+    }
+    iniciarLargada(&comp.largada);
+
+    // Dispara as threads auxiliares; a thread atual executa o bloco 0. Se alguma criação
+    // falhar, os blocos e a barreira são redistribuídos entre as threads criadas
+    for (int t = 0; t < threads; t++)
     {
-        arr[l + t] = tmp[t];
+        tarefas[t].comp = &comp;
+        tarefas[t].id = t;
     }
+    comp.threads = criarAuxiliares(ids, threads, radixTrabalhador, tarefas, sizeof(RadixTarefa));
+    pthread_barrier_init(&comp.barreira, NULL, (unsigned)comp.threads);
+    abrirLargada(&comp.largada);
+    radixTrabalhador(&tarefas[0]);
+    for (int t = 1; t < comp.threads; t++)
+        pthread_join(ids[t], NULL);
+
+    pthread_barrier_destroy(&comp.barreira);
+    destruirLargada(&comp.largada);
+    free(comp.histogramas);
+    free(tarefas);
+    free(ids);
+    // Com número par de passadas o resultado volta ao vetor original
+    return passadas % 2 == 0 ? pares : tmp;
 }
 
-// Procedimento recursivo de mergesort
-void mergesortContainersRec(Container *arr, Container *tmp, int l, int r)
+// Função para ordenar pares (código, índice) de um vetor de códigos; retorna NULL em falha de alocação
+ParChave *ordenarPares(const uint64_t *codigos, int n, TipoOrdenacao ordenacao, int threads)
 {
-    // Caso base da recursão
-    if (l >= r) return;
-    // Divide o array em duas metades
-    int m = l + (r - l) / 2;
-    // Chama recursivamente para ordenar as duas metades
-    mergesortContainersRec(arr, tmp, l, m);
-    mergesortContainersRec(arr, tmp, m + 1, r);
-    // Mescla as duas metades ordenadas
-    mergeContainers(arr, tmp, l, m, r);
+    size_t qtd = n > 0 ? (size_t)n : 1;
+    ParChave *pares = malloc(sizeof(ParChave) * qtd);
+    ParChave *tmp = malloc(sizeof(ParChave) * qtd);
+    if (!pares || !tmp)
+    {
+        free(pares); free(tmp);
+        return NULL;
+    }
+    // Monta os pares a partir dos códigos
+    for (int i = 0; i < n; i++)
+    {
+        pares[i].chave = codigos[i];
+        pares[i].indice = (uint32_t)i;
+    }
+    ParChave *resultado = pares;
+    if (ordenacao == ORDENACAO_RADIX) resultado = radixSortPares(pares, tmp, n, threads);
+    else mergesortParesParalelo(pares, (size_t)n, tmp, threads);
+    // Libera o vetor que não ficou com o resultado
+    if (resultado == pares) free(tmp);
+    else if (resultado == tmp) free(pares);
+    else { free(pares); free(tmp); }
+    return resultado;
 }
 
-// Procedimento principal de mergesort
-void mergesortContainers(Container *arr, int n)
+// Procedimento de ordenação dos containers: ordena os pares e reorganiza os vetores pelo índice
+void ordenarContainers(ContainerArray *arr, TipoOrdenacao ordenacao, int threads)
 {
     // Verifica se o array tem mais de um elemento
-    if (n <= 1) return;
-    // Aloca memória temporária para a mesclagem
-    Container *tmp = malloc(sizeof(Container) * n);
-    // Verifica se a alocação foi bem-sucedida
-    if (!tmp)
+    if (arr->qtd <= 1) return;
+    ParChave *pares = ordenarPares(arr->codigos, arr->qtd, ordenacao, threads);
+    ContainerArray ordenado = alocarContainers(arr->qtd);
+    if (!pares || !ordenado.codigos)
     {
-        fprintf(stderr, "Erro de alocação no mergesort.\n");
+        fprintf(stderr, "Erro de alocação na ordenação.\n");
+        free(pares);
+        liberarContainers(&ordenado);
         return;
     }
-    // Chama o procedimento recursivo
-    mergesortContainersRec(arr, tmp, 0, n - 1);
-    // Libera a memória temporária
-    free(tmp);
+    // Copia cada container para sua posição ordenada
+    for (int k = 0; k < arr->qtd; k++)
+    {
+        uint32_t origem = pares[k].indice;
+        ordenado.codigos[k] = pares[k].chave;
+        ordenado.cnpjs[k] = arr->cnpjs[origem];
+        ordenado.pesos[k] = arr->pesos[origem];
+        ordenado.temDivergenciaCNPJ[k] = arr->temDivergenciaCNPJ[origem];
+    }
+    free(pares);
+    liberarContainers(arr);
+    *arr = ordenado;
 }
 
-// Busca binária para encontrar um container pelo código
-int buscarBinariaContainer(Container *dados, int n, const char *codigo)
+// Estratégias de junção entre manifesto declarado e observado
+typedef enum
 {
-    // Inicializa os índices de busca
-    int menor = 0, maior = n - 1;
-    // Realiza a busca binária
-    while (menor <= maior)
+    JUNCAO_AUTO,
+    JUNCAO_HASH,
+    JUNCAO_MERGE
+} TipoJuncao;
+
+// Opções de execução lidas da linha de comando
+typedef struct
+{
+    TipoJuncao juncao;
+    TipoOrdenacao ordenacao;
+    int threads;
+    const char *fonteStream; // Observações em tempo real ("-" para a entrada padrão)
+    long benchStream; // Quantidade de registros do benchmark do modo contínuo
+    const char *snapshot; // Snapshot binário do manifesto declarado
+    int compilar; // Gera o snapshot em vez de auditar
+    const char *consultas; // Consultas de desvio de peso após a auditoria ("-" para a entrada padrão)
+    const char *salvarEstado; // Grava o estado da auditoria em lote para o modo delta
+    const char *delta; // Estado a atualizar com a revisão lida do arquivo de entrada
+} Configuracao;
+
+// Acima desse número de observados a tabela hash deixa de caber em cache e o sort-merge compensa
+#define LIMITE_JUNCAO_HASH (1 << 22)
+
+// Buffer de saída em memória que cresce conforme necessário
+typedef struct
+{
+    char *dados;
+    size_t tam;
+    size_t cap;
+} BufferSaida;
+
+// Procedimento para anexar texto formatado ao buffer de saída
+void bufferPrintf(BufferSaida *buf, const char *formato, ...)
+{
+    // Garante espaço para a maior linha possível de divergência
+    if (buf->cap - buf->tam < 256)
     {
-        // Calcula o índice médio
-        int mid = menor + (maior - menor) / 2;
-        // Compara o código do container médio com o código buscado
-        int cmp = strcmp(dados[mid].codigo, codigo);
-        // Ajusta os índices com base na comparação
-        if (cmp == 0) return mid;
-        // Se o código do container médio for menor, busca na metade direita
-        if (cmp < 0) menor = mid + 1;
-        // Se o código do container médio for maior, busca na metade esquerda
-        else maior = mid - 1;
+        // Dobra a capacidade do buffer
+        size_t novaCap = buf->cap ? buf->cap * 2 : 4096;
+        char *novo = realloc(buf->dados, novaCap);
+        if (!novo)
+        {
+            fprintf(stderr, "Erro de alocação no buffer de saída.\n");
+            return;
+        }
+        buf->dados = novo;
+        buf->cap = novaCap;
+    }
+    // Escreve a linha formatada no final do buffer
+    va_list args;
+    va_start(args, formato);
+    int escritos = vsnprintf(buf->dados + buf->tam, buf->cap - buf->tam, formato, args);
+    va_end(args);
+    if (escritos > 0) buf->tam += (size_t)escritos;
+}
+
+// Função de hash (finalizador do splitmix64) para o código compactado
+uint64_t hashCodigo(uint64_t codigo)
+{
+    // Espalha os bits da chave para que os bits baixos fiquem uniformes
+    codigo ^= codigo >> 30;
+    codigo *= 0xBF58476D1CE4E5B9ULL;
+    codigo ^= codigo >> 27;
+    codigo *= 0x94D049BB133111EBULL;
+    codigo ^= codigo >> 31;
+    return codigo;
+}
+
+// Tabela hash com endereçamento aberto (sondagem linear) indexando um manifesto pelo código
+typedef struct
+{
+    int *slots; // Índice do container + 1 (0 indica slot vazio)
+    uint64_t mascara;
+} TabelaHash;
+
+// Função para alocar uma tabela hash vazia com espaço para até 'elementos' containers
+TabelaHash criarTabelaHash(uint64_t elementos)
+{
+    TabelaHash tabela = {NULL, 0};
+    // Capacidade potência de 2 com fator de carga de no máximo 50%
+    uint64_t cap = 16;
+    while (cap < elementos * 2) cap <<= 1;
+    tabela.slots = calloc(cap, sizeof(int));
+    if (!tabela.slots)
+    {
+        fprintf(stderr, "Erro de alocação da tabela hash.\n");
+        return tabela;
+    }
+    tabela.mascara = cap - 1;
+    return tabela;
+}
+
+// Procedimento para inserir o container j na tabela
+void inserirTabelaHash(TabelaHash *tabela, ContainerArray *arr, int j)
+{
+    uint64_t pos = hashCodigo(arr->codigos[j]) & tabela->mascara;
+    // Sonda até achar um slot vazio ou o mesmo código (mantém a primeira ocorrência)
+    while (tabela->slots[pos] && arr->codigos[tabela->slots[pos] - 1] != arr->codigos[j])
+        pos = (pos + 1) & tabela->mascara;
+    if (!tabela->slots[pos]) tabela->slots[pos] = j + 1;
+}
+
+// Função para construir a tabela hash sobre os containers de um manifesto
+TabelaHash construirTabelaHash(ContainerArray *arr)
+{
+    TabelaHash tabela = criarTabelaHash((uint64_t)arr->qtd);
+    if (!tabela.slots) return tabela;
+    // Insere cada container do manifesto
+    for (int j = 0; j < arr->qtd; j++)
+        inserirTabelaHash(&tabela, arr, j);
+    return tabela;
+}
+
+// Função para buscar um código na tabela hash, retornando o índice do container ou -1
+int buscarTabelaHash(TabelaHash *tabela, ContainerArray *arr, uint64_t codigo)
+{
+    uint64_t pos = hashCodigo(codigo) & tabela->mascara;
+    // Sonda até encontrar o código ou um slot vazio
+    while (tabela->slots[pos])
+    {
+        int idx = tabela->slots[pos] - 1;
+        if (arr->codigos[idx] == codigo) return idx;
+        pos = (pos + 1) & tabela->mascara;
     }
     return -1;
 }
 
-// Procedimento para comparar CNPJs e escrever no arquivo de saída
-void compararCNPJs(ContainerArray *originais, ContainerArray *observados, FILE* output)
+// Função de junção por hash: para cada original, o índice do observado correspondente (ou -1)
+int *juntarHash(ContainerArray *originais, ContainerArray *observados)
 {
+    int *correspondencia = malloc(sizeof(int) * (originais->qtd > 0 ? originais->qtd : 1));
+    if (!correspondencia) return NULL;
+    // Constrói a tabela sobre os observados
+    TabelaHash tabela = construirTabelaHash(observados);
+    if (!tabela.slots)
+    {
+        free(correspondencia);
+        return NULL;
+    }
+    // Sonda a tabela com cada original, na ordem do manifesto
+    for (int i = 0; i < originais->qtd; i++)
+        correspondencia[i] = buscarTabelaHash(&tabela, observados, originais->codigos[i]);
+    free(tabela.slots);
+    return correspondencia;
+}
+
+// Função de junção sort-merge: ordena ambos os lados e faz uma mescla linear
+int *juntarSortMerge(ContainerArray *originais, ContainerArray *observados, const Configuracao *cfg)
+{
+    int n = originais->qtd;
+    int *correspondencia = malloc(sizeof(int) * (n > 0 ? n : 1));
+    if (!correspondencia) return NULL;
+    for (int i = 0; i < n; i++) correspondencia[i] = -1;
+
+    // Ordena os observados e os pares (código, índice) dos originais, preservando a ordem do manifesto
+    ordenarContainers(observados, cfg->ordenacao, cfg->threads);
+    ParChave *ordem = ordenarPares(originais->codigos, n, cfg->ordenacao, cfg->threads);
+    if (!ordem)
+    {
+        free(correspondencia);
+        return NULL;
+    }
+
+    // Mescla linear dos dois lados ordenados
+    int i = 0, j = 0;
+    while (i < n && j < observados->qtd)
+    {
+        uint64_t codigoOriginal = ordem[i].chave;
+        // Códigos iguais: registra a correspondência e avança no lado original
+        if (codigoOriginal == observados->codigos[j]) correspondencia[ordem[i++].indice] = j;
+        // Avança o lado com o menor código
+        else if (codigoOriginal < observados->codigos[j]) i++;
+        else j++;
+    }
+    free(ordem);
+    return correspondencia;
+}
+
+// Função que aplica a regra dos 10%; retorna 1 se o peso observado diverge do original
+int pesoDiverge(int pesoOriginal, int pesoObservado, int *diferenca, double *percentual)
+{
+    // Calcula a diferença absoluta entre os pesos
+    *diferenca = abs(pesoOriginal - pesoObservado);
+    // Evita divisão por zero
+    if (pesoOriginal == 0) return 0;
+    // Calcula o percentual da diferença
+    *percentual = round((double)*diferenca / (double)pesoOriginal * 100.0);
+    // Diverge se o percentual for maior que 10.0%
+    return *percentual > 10.0;
+}
+
+// Procedimento de auditoria: checa CNPJ e peso de cada container em uma única passada
+void auditarContainers(ContainerArray *originais, ContainerArray *observados, int *correspondencia, FILE* output)
+{
+    // Divergências de peso são acumuladas e escritas após as de CNPJ
+    BufferSaida pesos = {NULL, 0, 0};
+
     // Itera sobre os containers originais
     for (int i = 0; i < originais->qtd; i++)
     {
-        // Busca o índice do container correspondente nos observados
-        int idx = buscarBinariaContainer(observados->containers, observados->qtd, originais->containers[i].codigo);
-        // Se encontrado, compara os CNPJs
-        if (idx != -1)
+        int idx = correspondencia[i];
+        // Ignora containers sem correspondência
+        if (idx == -1) continue;
+        // Textos formatados apenas quando há divergência a escrever
+        char codigo[12], cnpjOriginal[19], cnpjObservado[19];
+
+        // Se os CNPJs forem diferentes, escreve no arquivo de saída
+        if (originais->cnpjs[i] != observados->cnpjs[idx])
         {
-            // Se os CNPJs forem diferentes, escreve no arquivo de saída
-            if (strcmp(originais->containers[i].cnpj, observados->containers[idx].cnpj) != 0)
+            decodificarCodigo(originais->codigos[i], codigo);
+            decodificarCNPJ(originais->cnpjs[i], cnpjOriginal);
+            decodificarCNPJ(observados->cnpjs[idx], cnpjObservado);
+            fprintf(output, "%s:%s<->%s\n", codigo, cnpjOriginal, cnpjObservado);
+            // Marca que houve divergência de CNPJ
+            originais->temDivergenciaCNPJ[i] = 1;
+            continue;
+        }
+
+        // Se o peso divergir mais de 10%, acumula a divergência
+        int diferenca;
+        double percentual;
+        if (pesoDiverge(originais->pesos[i], observados->pesos[idx], &diferenca, &percentual))
+        {
+            decodificarCodigo(originais->codigos[i], codigo);
+            bufferPrintf(&pesos, "%s:%dkg(%.0f%%)\n", codigo, diferenca, round(percentual));
+        }
+    }
+
+    // Escreve as divergências de peso depois de todas as de CNPJ
+    if (pesos.tam > 0) fwrite(pesos.dados, 1, pesos.tam, output);
+    free(pesos.dados);
+}
+
+// Abaixo desse número de originais a auditoria paralela não compensa
+#define MIN_AUDITORIA_PARALELA (1 << 16)
+
+// Linhas de divergência de uma partição, com o índice original de cada uma para a mescla final
+typedef struct
+{
+    BufferSaida texto;
+    int *indices;
+    size_t *fins;
+    size_t qtd;
+    size_t cap;
+} ListaLinhas;
+
+// Procedimento para registrar o fim da última linha escrita no texto da lista
+void listaRegistrar(ListaLinhas *lista, int indice)
+{
+    // Cresce os vetores de metadados quando necessário
+    if (lista->qtd == lista->cap)
+    {
+        size_t novaCap = lista->cap ? lista->cap * 2 : 256;
+        int *indices = realloc(lista->indices, sizeof(int) * novaCap);
+        if (indices) lista->indices = indices;
+        size_t *fins = realloc(lista->fins, sizeof(size_t) * novaCap);
+        if (fins) lista->fins = fins;
+        if (!indices || !fins)
+        {
+            fprintf(stderr, "Erro de alocação na lista de divergências.\n");
+            return;
+        }
+        lista->cap = novaCap;
+    }
+    lista->indices[lista->qtd] = indice;
+    lista->fins[lista->qtd++] = lista->texto.tam;
+}
+
+// Estado compartilhado pela auditoria particionada
+typedef struct
+{
+    ContainerArray *originais;
+    ContainerArray *observados;
+    int *correspondencia;
+    int threads;
+    int *membros; // Índices dos originais agrupados por partição, em ordem crescente
+    size_t (*contagens)[64];
+    size_t iniciosParticao[65];
+    ListaLinhas *cnpjs;
+    ListaLinhas *pesos;
+    pthread_barrier_t barreira;
+    Largada largada;
+} AuditoriaCompartilhada;
+
+typedef struct
+{
+    AuditoriaCompartilhada *comp;
+    int id;
+} AuditoriaTarefa;
+
+// Procedimento de cada thread: particiona seu bloco pelo hash do código e audita a sua partição
+void *auditoriaTrabalhador(void *arg)
+{
+    AuditoriaTarefa *tarefa = arg;
+    AuditoriaCompartilhada *comp = tarefa->comp;
+    aguardarLargada(&comp->largada);
+    ContainerArray *originais = comp->originais;
+    ContainerArray *observados = comp->observados;
+    int t = tarefa->id, T = comp->threads, n = originais->qtd;
+    int inicio = (int)((int64_t)n * t / T);
+    int fim = (int)((int64_t)n * (t + 1) / T);
+    size_t *cont = comp->contagens[t];
+
+    // Conta quantos originais do bloco local caem em cada partição
+    memset(cont, 0, sizeof(comp->contagens[t]));
+    for (int i = inicio; i < fim; i++)
+        cont[hashCodigo(originais->codigos[i]) % (uint64_t)T]++;
+    pthread_barrier_wait(&comp->barreira);
+
+    // Converte as contagens em posições (partição, depois bloco: mantém a ordem do manifesto)
+    if (t == 0)
+    {
+        size_t soma = 0;
+        for (int p = 0; p < T; p++)
+        {
+            comp->iniciosParticao[p] = soma;
+            for (int b = 0; b < T; b++)
             {
-                fprintf(output, "%s:%s<->%s\n",  originais->containers[i].codigo,
-                                                originais->containers[i].cnpj,
-                                                observados->containers[idx].cnpj);
-                // Marca que houve divergência de CNPJ
-                originais->containers[i].temDivergenciaCNPJ = 1;
+                size_t qtd = comp->contagens[b][p];
+                comp->contagens[b][p] = soma;
+                soma += qtd;
             }
         }
+        comp->iniciosParticao[T] = soma;
     }
+    pthread_barrier_wait(&comp->barreira);
+
+    // Espalha os índices do bloco local
+    for (int i = inicio; i < fim; i++)
+        comp->membros[cont[hashCodigo(originais->codigos[i]) % (uint64_t)T]++] = i;
+    pthread_barrier_wait(&comp->barreira);
+
+    // Audita a partição t escrevendo em buffers privados
+    ListaLinhas *cnpjs = &comp->cnpjs[t];
+    ListaLinhas *pesos = &comp->pesos[t];
+    for (size_t k = comp->iniciosParticao[t]; k < comp->iniciosParticao[t + 1]; k++)
+    {
+        int i = comp->membros[k];
+        int idx = comp->correspondencia[i];
+        if (idx == -1) continue;
+        char codigo[12], cnpjOriginal[19], cnpjObservado[19];
+
+        if (originais->cnpjs[i] != observados->cnpjs[idx])
+        {
+            decodificarCodigo(originais->codigos[i], codigo);
+            decodificarCNPJ(originais->cnpjs[i], cnpjOriginal);
+            decodificarCNPJ(observados->cnpjs[idx], cnpjObservado);
+            bufferPrintf(&cnpjs->texto, "%s:%s<->%s\n", codigo, cnpjOriginal, cnpjObservado);
+            listaRegistrar(cnpjs, i);
+            originais->temDivergenciaCNPJ[i] = 1;
+            continue;
+        }
+        int diferenca;
+        double percentual;
+        if (pesoDiverge(originais->pesos[i], observados->pesos[idx], &diferenca, &percentual))
+        {
+            decodificarCodigo(originais->codigos[i], codigo);
+            bufferPrintf(&pesos->texto, "%s:%dkg(%.0f%%)\n", codigo, diferenca, round(percentual));
+            listaRegistrar(pesos, i);
+        }
+    }
+    return NULL;
 }
 
-// Procedimento para comparar pesos e escrever no arquivo de saída
-void compararPesos(ContainerArray *originais, ContainerArray *observados, FILE* output)
+// Procedimento de mescla final: escreve as linhas das partições na ordem do manifesto original
+void escreverListasOrdenadas(ListaLinhas *listas, int qtdListas, FILE *output)
 {
-    // Itera sobre os containers originais
+    size_t pos[64] = {0};
+    while (1)
+    {
+        // Escolhe a partição cuja próxima linha tem o menor índice original
+        int escolhida = -1;
+        for (int p = 0; p < qtdListas; p++)
+            if (pos[p] < listas[p].qtd && (escolhida == -1 || listas[p].indices[pos[p]] < listas[escolhida].indices[pos[escolhida]]))
+                escolhida = p;
+        if (escolhida == -1) break;
+        // Escreve a linha escolhida
+        ListaLinhas *l = &listas[escolhida];
+        size_t ini = pos[escolhida] ? l->fins[pos[escolhida] - 1] : 0;
+        fwrite(l->texto.dados + ini, 1, l->fins[pos[escolhida]] - ini, output);
+        pos[escolhida]++;
+    }
+}
+
+// Procedimento de auditoria particionada por hash do código entre várias threads
+void auditarContainersParalelo(ContainerArray *originais, ContainerArray *observados, int *correspondencia, FILE* output, int threads)
+{
+    // Limita as partições ao tamanho da entrada (e ao máximo suportado pela mescla)
+    if (threads > 64) threads = 64;
+    if (threads > originais->qtd / MIN_AUDITORIA_PARALELA) threads = originais->qtd / MIN_AUDITORIA_PARALELA;
+    if (threads <= 1)
+    {
+        auditarContainers(originais, observados, correspondencia, output);
+        return;
+    }
+
+    AuditoriaCompartilhada comp;
+    comp.originais = originais;
+    comp.observados = observados;
+    comp.correspondencia = correspondencia;
+    comp.threads = threads;
+    comp.membros = malloc(sizeof(int) * (size_t)originais->qtd);
+    comp.contagens = malloc(sizeof(*comp.contagens) * threads);
+    comp.cnpjs = calloc((size_t)threads, sizeof(ListaLinhas));
+    comp.pesos = calloc((size_t)threads, sizeof(ListaLinhas));
+    AuditoriaTarefa *tarefas = malloc(sizeof(AuditoriaTarefa) * threads);
+    pthread_t *ids = malloc(sizeof(pthread_t) * threads);
+    if (!comp.membros || !comp.contagens || !comp.cnpjs || !comp.pesos || !tarefas || !ids)
+    {
+        free(comp.membros); free(comp.contagens); free(comp.cnpjs); free(comp.pesos); free(tarefas); free(ids);
+        auditarContainers(originais, observados, correspondencia, output);
+        return;
+    }
+    iniciarLargada(&comp.largada);
+
+    // Dispara as threads auxiliares; a thread atual cuida da partição 0. Com falha na
+    // criação, as partições são refeitas entre as threads criadas
+    for (int t = 0; t < threads; t++)
+    {
+        tarefas[t].comp = &comp;
+        tarefas[t].id = t;
+    }
+    comp.threads = criarAuxiliares(ids, threads, auditoriaTrabalhador, tarefas, sizeof(AuditoriaTarefa));
+    pthread_barrier_init(&comp.barreira, NULL, (unsigned)comp.threads);
+    abrirLargada(&comp.largada);
+    auditoriaTrabalhador(&tarefas[0]);
+    for (int t = 1; t < comp.threads; t++)
+        pthread_join(ids[t], NULL);
+    pthread_barrier_destroy(&comp.barreira);
+    destruirLargada(&comp.largada);
+
+    // Todas as divergências de CNPJ, depois todas as de peso, na ordem do manifesto
+    escreverListasOrdenadas(comp.cnpjs, comp.threads, output);
+    escreverListasOrdenadas(comp.pesos, comp.threads, output);
+
+    for (int t = 0; t < threads; t++)
+    {
+        free(comp.cnpjs[t].texto.dados); free(comp.cnpjs[t].indices); free(comp.cnpjs[t].fins);
+        free(comp.pesos[t].texto.dados); free(comp.pesos[t].indices); free(comp.pesos[t].fins);
+    }
+    free(comp.membros); free(comp.contagens); free(comp.cnpjs); free(comp.pesos); free(tarefas); free(ids);
+}
+
+// Desvio de peso de um container casado e sem divergência de CNPJ
+typedef struct
+{
+    double razao; // Diferença relativa exata (diferença / peso original)
+    int diferenca;
+    int indice;
+} Desvio;
+
+// Armazém de desvios construído uma vez a partir da junção, para consultas repetidas
+typedef struct
+{
+    Desvio *itens; // Ordem do manifesto original
+    size_t qtd;
+    Desvio *ordenados; // Índice por desvio decrescente, construído na primeira consulta por faixa
+} ArmazemDesvios;
+
+// Função que indica se o desvio a é pior que b (maior razão; empate pelo menor índice)
+int desvioPior(const Desvio *a, const Desvio *b)
+{
+    if (a->razao != b->razao) return a->razao > b->razao;
+    return a->indice < b->indice;
+}
+
+// Função de comparação para ordenar desvios do pior para o melhor
+int compararDesvios(const void *a, const void *b)
+{
+    if (desvioPior(a, b)) return -1;
+    if (desvioPior(b, a)) return 1;
+    return 0;
+}
+
+// Função para construir o armazém de desvios reaproveitando a junção já feita
+ArmazemDesvios construirArmazemDesvios(ContainerArray *originais, ContainerArray *observados, int *correspondencia)
+{
+    ArmazemDesvios armazem = {NULL, 0, NULL};
+    armazem.itens = malloc(sizeof(Desvio) * (originais->qtd > 0 ? (size_t)originais->qtd : 1));
+    if (!armazem.itens) return armazem;
     for (int i = 0; i < originais->qtd; i++)
     {
-        int idx = buscarBinariaContainer(observados->containers, observados->qtd, originais->containers[i].codigo);
-        // Se encontrado e não houve divergência de CNPJ, compara os pesos
-        if (idx != -1 && !originais->containers[i].temDivergenciaCNPJ)
-        {
-            // Armazena os pesos original e observado
-            int pesoOriginal = originais->containers[i].peso;
-            int pesoObservado = observados->containers[idx].peso;
-            // Calcula a diferença absoluta entre os pesos
-            int diferenca = abs(pesoOriginal - pesoObservado);
-            // Evita divisão por zero
-            if (pesoOriginal == 0) {
-                continue;
+        int idx = correspondencia[i];
+        // Mesmo critério de elegibilidade da regra dos 10%
+        if (idx == -1 || originais->cnpjs[i] != observados->cnpjs[idx] || originais->pesos[i] == 0) continue;
+        Desvio *d = &armazem.itens[armazem.qtd++];
+        d->diferenca = abs(originais->pesos[i] - observados->pesos[idx]);
+        d->razao = (double)d->diferenca / (double)originais->pesos[i];
+        d->indice = i;
+    }
+    return armazem;
+}
+
+// Procedimento para escrever um desvio no formato do relatório
+void escreverDesvio(ContainerArray *originais, const Desvio *d, FILE *saida)
+{
+    char codigo[12];
+    decodificarCodigo(originais->codigos[d->indice], codigo);
+    fprintf(saida, "%s:%dkg(%.0f%%)\n", codigo, d->diferenca, round(d->razao * 100.0));
+}
+
+// Procedimento para descer um elemento no heap mínimo (a raiz é o "menos pior" dos K mantidos)
+void descerHeapDesvios(Desvio *heap, size_t n, size_t i)
+{
+    while (1)
+    {
+        size_t menor = i, esq = 2 * i + 1, dir = 2 * i + 2;
+        if (esq < n && desvioPior(&heap[menor], &heap[esq])) menor = esq;
+        if (dir < n && desvioPior(&heap[menor], &heap[dir])) menor = dir;
+        if (menor == i) return;
+        Desvio tmp = heap[i];
+        heap[i] = heap[menor];
+        heap[menor] = tmp;
+        i = menor;
+    }
+}
+
+// Procedimento de consulta top-K com heap limitado: os K piores desvios em ordem decrescente
+void consultarTopK(ArmazemDesvios *armazem, ContainerArray *originais, size_t k, FILE *saida)
+{
+    if (k > armazem->qtd) k = armazem->qtd;
+    if (k == 0) return;
+    Desvio *heap = malloc(sizeof(Desvio) * k);
+    if (!heap) return;
+    // Os K primeiros formam o heap inicial
+    memcpy(heap, armazem->itens, sizeof(Desvio) * k);
+    for (size_t i = k / 2; i-- > 0;) descerHeapDesvios(heap, k, i);
+    // Cada desvio pior que a raiz a substitui
+    for (size_t i = k; i < armazem->qtd; i++)
+        if (desvioPior(&armazem->itens[i], &heap[0]))
+        {
+            heap[0] = armazem->itens[i];
+            descerHeapDesvios(heap, k, 0);
+        }
+    // Ordena o resultado do pior para o melhor
+    qsort(heap, k, sizeof(Desvio), compararDesvios);
+    for (size_t i = 0; i < k; i++) escreverDesvio(originais, &heap[i], saida);
+    free(heap);
+}
+
+// Procedimento de consulta por faixa: todos os desvios cujo percentual arredondado passa do limiar
+void consultarAcima(ArmazemDesvios *armazem, ContainerArray *originais, double limiar, FILE *saida)
+{
+    // Constrói o índice ordenado uma única vez
+    if (!armazem->ordenados)
+    {
+        armazem->ordenados = malloc(sizeof(Desvio) * (armazem->qtd > 0 ? armazem->qtd : 1));
+        if (!armazem->ordenados) return;
+        memcpy(armazem->ordenados, armazem->itens, sizeof(Desvio) * armazem->qtd);
+        qsort(armazem->ordenados, armazem->qtd, sizeof(Desvio), compararDesvios);
+    }
+    // Busca binária pelo primeiro desvio que não passa do limiar (o arredondamento preserva a ordem)
+    size_t menor = 0, maior = armazem->qtd;
+    while (menor < maior)
+    {
+        size_t mid = menor + (maior - menor) / 2;
+        if (round(armazem->ordenados[mid].razao * 100.0) > limiar) menor = mid + 1;
+        else maior = mid;
+    }
+    for (size_t i = 0; i < menor; i++) escreverDesvio(originais, &armazem->ordenados[i], saida);
+}
+
+// Procedimento que responde consultas ("top K" ou "acima P") lidas uma por linha
+void responderConsultas(ArmazemDesvios *armazem, ContainerArray *originais, FILE *fonte, FILE *saida)
+{
+    char linha[128], tipo[16];
+    double valor;
+    while (fgets(linha, sizeof(linha), fonte))
+    {
+        // A forma negada também recusa NaN
+        if (sscanf(linha, "%15s %lf", tipo, &valor) != 2 || !(valor >= 0))
+        {
+            if (linha[0] != '\n') fprintf(stderr, "Consulta inválida: %s", linha);
+            continue;
+        }
+        int topK = strcmp(tipo, "top") == 0;
+        if (!topK && strcmp(tipo, "acima") != 0)
+        {
+            fprintf(stderr, "Consulta desconhecida: %s\n", tipo);
+            continue;
+        }
+        // Cabeçalho separando as respostas
+        fprintf(saida, "# %s %g\n", tipo, valor);
+        // K acima do tamanho do manifesto (inclusive infinito) equivale a todos; só então converte
+        if (topK) consultarTopK(armazem, originais, valor < originais->qtd ? (size_t)valor : (size_t)originais->qtd, saida);
+        else consultarAcima(armazem, originais, valor, saida);
+        fflush(saida);
+    }
+}
+
+// Função que audita um registro observado recebido do portão; retorna 0 se o registro for inválido
+int processarObservacao(const char *linha, ContainerArray *originais, TabelaHash *indice, FILE *output)
+{
+    char texto[MAX_CODE_LENGTH], cnpjTexto[MAX_CNPJ_LENGTH];
+    uint64_t codigo, cnpj;
+    int peso;
+    // Lê e compacta os campos do registro
+    if (sscanf(linha, "%31s %31s %d", texto, cnpjTexto, &peso) != 3
+        || !codificarCodigo(texto, &codigo) || !codificarCNPJ(cnpjTexto, &cnpj))
+        return 0;
+
+    // Containers fora do manifesto declarado não geram divergência
+    int i = buscarTabelaHash(indice, originais, codigo);
+    if (i == -1) return 1;
+
+    // Divergência de CNPJ tem precedência sobre a de peso, como no relatório em lote
+    if (originais->cnpjs[i] != cnpj)
+    {
+        char cnpjOriginal[19];
+        decodificarCNPJ(originais->cnpjs[i], cnpjOriginal);
+        fprintf(output, "%s:%s<->%s\n", texto, cnpjOriginal, cnpjTexto);
+        fflush(output);
+        return 1;
+    }
+    int diferenca;
+    double percentual;
+    if (pesoDiverge(originais->pesos[i], peso, &diferenca, &percentual))
+    {
+        fprintf(output, "%s:%dkg(%.0f%%)\n", texto, diferenca, round(percentual));
+        fflush(output);
+    }
+    return 1;
+}
+
+// Procedimento de auditoria contínua: lê observações uma a uma e escreve cada divergência imediatamente
+void auditarStream(ContainerArray *originais, TabelaHash *indice, FILE *fonte, FILE *output)
+{
+    // A primeira linha pode trazer a quantidade de registros, como no formato em lote
+    char linha[256];
+    int numero = 0;
+    while (fgets(linha, sizeof(linha), fonte))
+    {
+        numero++;
+        // Ignora linhas vazias e cabeçalhos numéricos
+        if (linha[0] == '\n' || (linha[0] >= '0' && linha[0] <= '9')) continue;
+        if (!processarObservacao(linha, originais, indice, output))
+            fprintf(stderr, "Registro de observação inválido (linha %d).\n", numero);
+    }
+}
+
+// Função de comparação de latências para o qsort
+int compararLatencias(const void *a, const void *b)
+{
+    int64_t x = *(const int64_t *)a, y = *(const int64_t *)b;
+    return (x > y) - (x < y);
+}
+
+// Função que retorna o relógio monotônico em nanossegundos
+int64_t agoraNs(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+// Procedimento de benchmark do modo contínuo: mede vazão e latência por registro
+void benchmarkStream(ContainerArray *originais, TabelaHash *indice, long qtdRegistros, FILE *output)
+{
+    if (originais->qtd == 0 || qtdRegistros <= 0) return;
+    int64_t *latencias = malloc(sizeof(int64_t) * (size_t)qtdRegistros);
+    if (!latencias)
+    {
+        fprintf(stderr, "Erro de alocação no benchmark.\n");
+        return;
+    }
+
+    int64_t inicio = agoraNs();
+    for (long k = 0; k < qtdRegistros; k++)
+    {
+        // Registro sintético derivado do manifesto: CNPJ trocado a cada 10, peso alterado a cada 3
+        int i = (int)(k % originais->qtd);
+        char codigo[12], cnpj[19], linha[64];
+        decodificarCodigo(originais->codigos[i], codigo);
+        decodificarCNPJ(originais->cnpjs[i] + (k % 10 == 0), cnpj);
+        snprintf(linha, sizeof(linha), "%s %s %d", codigo, cnpj, originais->pesos[i] + (k % 3 == 0 ? originais->pesos[i] / 4 : 0));
+
+        // Mede do recebimento do registro até a divergência ser escrita
+        int64_t t0 = agoraNs();
+        processarObservacao(linha, originais, indice, output);
+        latencias[k] = agoraNs() - t0;
+    }
+    double total = (double)(agoraNs() - inicio) / 1e9;
+
+    // Percentis de latência
+    qsort(latencias, (size_t)qtdRegistros, sizeof(int64_t), compararLatencias);
+    printf("registros=%ld vazao=%.0f reg/s p50=%lldns p99=%lldns max=%lldns\n",
+           qtdRegistros, (double)qtdRegistros / total,
+           (long long)latencias[qtdRegistros / 2],
+           (long long)latencias[(qtdRegistros * 99) / 100],
+           (long long)latencias[qtdRegistros - 1]);
+    free(latencias);
+}
+
+// Snapshot binário do manifesto declarado: cabeçalho seguido dos vetores e da tabela hash, alinhados em 8 bytes
+#define MAGICA_SNAPSHOT "PORTOSNP"
+#define VERSAO_SNAPSHOT 1
+
+typedef struct
+{
+    char magica[8];
+    uint32_t versao;
+    uint32_t reservado;
+    uint64_t qtd;
+    uint64_t capacidadeHash;
+    uint64_t offCodigos;
+    uint64_t offCnpjs;
+    uint64_t offPesos;
+    uint64_t offDivergencias;
+    uint64_t offSlots;
+    uint64_t tamanho;
+} CabecalhoSnapshot;
+
+// Região mapeada de um snapshot aberto
+typedef struct
+{
+    void *base;
+    size_t tamanho;
+} Snapshot;
+
+// Função que arredonda um deslocamento para múltiplo de 8
+uint64_t alinhar8(uint64_t off)
+{
+    return (off + 7) & ~(uint64_t)7;
+}
+
+// Procedimento para escrever um vetor no deslocamento indicado, completando o intervalo com zeros
+void escreverRegiao(FILE *arquivo, uint64_t off, const void *dados, size_t bytes)
+{
+    static const char zeros[4096] = {0};
+    fseek(arquivo, 0, SEEK_END);
+    long atual = ftell(arquivo);
+    // Preenche o alinhamento (ou a folga reservada) até o início da região
+    while (atual >= 0 && (uint64_t)atual < off)
+    {
+        size_t falta = (size_t)(off - (uint64_t)atual);
+        if (falta > sizeof(zeros)) falta = sizeof(zeros);
+        if (fwrite(zeros, 1, falta, arquivo) != falta) return;
+        atual += (long)falta;
+    }
+    if (bytes > 0) fwrite(dados, 1, bytes, arquivo);
+}
+
+// Função para compilar o manifesto declarado em um snapshot binário; retorna 0 em caso de erro
+int escreverSnapshot(ContainerArray *originais, FILE *arquivo)
+{
+    TabelaHash tabela = construirTabelaHash(originais);
+    if (!tabela.slots) return 0;
+    uint64_t n = (uint64_t)originais->qtd;
+
+    // Calcula o deslocamento de cada região
+    CabecalhoSnapshot cab;
+    memset(&cab, 0, sizeof(cab));
+    memcpy(cab.magica, MAGICA_SNAPSHOT, 8);
+    cab.versao = VERSAO_SNAPSHOT;
+    cab.qtd = n;
+    cab.capacidadeHash = tabela.mascara + 1;
+    cab.offCodigos = alinhar8(sizeof(CabecalhoSnapshot));
+    cab.offCnpjs = alinhar8(cab.offCodigos + n * sizeof(uint64_t));
+    cab.offPesos = alinhar8(cab.offCnpjs + n * sizeof(uint64_t));
+    cab.offDivergencias = alinhar8(cab.offPesos + n * sizeof(int));
+    cab.offSlots = alinhar8(cab.offDivergencias + n);
+    cab.tamanho = cab.offSlots + cab.capacidadeHash * sizeof(int);
+
+    // Grava cabeçalho e regiões em sequência
+    fwrite(&cab, sizeof(cab), 1, arquivo);
+    escreverRegiao(arquivo, cab.offCodigos, originais->codigos, n * sizeof(uint64_t));
+    escreverRegiao(arquivo, cab.offCnpjs, originais->cnpjs, n * sizeof(uint64_t));
+    escreverRegiao(arquivo, cab.offPesos, originais->pesos, n * sizeof(int));
+    escreverRegiao(arquivo, cab.offDivergencias, originais->temDivergenciaCNPJ, n);
+    escreverRegiao(arquivo, cab.offSlots, tabela.slots, cab.capacidadeHash * sizeof(int));
+    free(tabela.slots);
+    return !ferror(arquivo);
+}
+
+// Função para mapear um snapshot e consultá-lo no lugar, sem leitura nem alocação; retorna 0 em caso de erro
+int abrirSnapshot(const char *caminho, Snapshot *snap, ContainerArray *originais, TabelaHash *indice)
+{
+    int fd = open(caminho, O_RDONLY);
+    if (fd < 0) return 0;
+    struct stat info;
+    if (fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(CabecalhoSnapshot))
+    {
+        close(fd);
+        return 0;
+    }
+    // Mapeamento privado: a marcação de divergências não altera o arquivo
+    void *base = mmap(NULL, (size_t)info.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) return 0;
+
+    // Valida assinatura, versão e tamanho antes de confiar nos deslocamentos
+    CabecalhoSnapshot *cab = base;
+    if (memcmp(cab->magica, MAGICA_SNAPSHOT, 8) != 0 || cab->versao != VERSAO_SNAPSHOT
+        || cab->tamanho != (uint64_t)info.st_size || cab->qtd > INT32_MAX
+        || cab->capacidadeHash == 0 || (cab->capacidadeHash & (cab->capacidadeHash - 1)) != 0
+        || cab->offCnpjs < cab->offCodigos + cab->qtd * sizeof(uint64_t)
+        || cab->offPesos < cab->offCnpjs + cab->qtd * sizeof(uint64_t)
+        || cab->offDivergencias < cab->offPesos + cab->qtd * sizeof(int)
+        || cab->offSlots < cab->offDivergencias + cab->qtd
+        || cab->tamanho < cab->offSlots + cab->capacidadeHash * sizeof(int))
+    {
+        fprintf(stderr, "Snapshot inválido ou de versão incompatível.\n");
+        munmap(base, (size_t)info.st_size);
+        return 0;
+    }
+
+    // Aponta os vetores diretamente para a região mapeada
+    char *bytes = base;
+    originais->codigos = (uint64_t *)(bytes + cab->offCodigos);
+    originais->cnpjs = (uint64_t *)(bytes + cab->offCnpjs);
+    originais->pesos = (int *)(bytes + cab->offPesos);
+    originais->temDivergenciaCNPJ = (unsigned char *)(bytes + cab->offDivergencias);
+    originais->qtd = (int)cab->qtd;
+    indice->slots = (int *)(bytes + cab->offSlots);
+    indice->mascara = cab->capacidadeHash - 1;
+    snap->base = base;
+    snap->tamanho = (size_t)info.st_size;
+    return 1;
+}
+
+// Função de junção por hash usando um índice já existente sobre os originais (ex.: snapshot)
+int *juntarHashIndiceOriginais(ContainerArray *originais, TabelaHash *indice, ContainerArray *observados)
+{
+    int *correspondencia = malloc(sizeof(int) * (originais->qtd > 0 ? originais->qtd : 1));
+    if (!correspondencia) return NULL;
+    for (int i = 0; i < originais->qtd; i++) correspondencia[i] = -1;
+    // Sonda o índice com cada observado, mantendo a primeira ocorrência de cada código
+    for (int j = 0; j < observados->qtd; j++)
+    {
+        int i = buscarTabelaHash(indice, originais, observados->codigos[j]);
+        if (i != -1 && correspondencia[i] == -1) correspondencia[i] = j;
+    }
+    return correspondencia;
+}
+
+// Estado de auditoria persistido para o modo delta: manifesto declarado com folga para inserções,
+// estado de divergência por container, correspondências, observados ordenados pelo código e as
+// listas ordenadas dos containers que entram no relatório por CNPJ e por peso
+#define MAGICA_ESTADO "PORTOEST"
+#define VERSAO_ESTADO 2
+
+// Bits do estado de cada container original
+#define DIVERGENCIA_CNPJ 1
+#define DIVERGENCIA_PESO 2
+#define CONTAINER_REMOVIDO 4
+// Marca temporária dos containers já alterados pela revisão em curso
+#define ESTADO_ALTERADO 8
+
+typedef struct
+{
+    char magica[8];
+    uint32_t versao;
+    uint32_t reservado;
+    uint64_t qtdOriginais;
+    uint64_t capOriginais;
+    uint64_t qtdObservados;
+    uint64_t capacidadeHash;
+    uint64_t offCodigos;
+    uint64_t offCnpjs;
+    uint64_t offPesos;
+    uint64_t offEstados;
+    uint64_t offCorrespondencia;
+    uint64_t offObsCodigos;
+    uint64_t offObsCnpjs;
+    uint64_t offObsPesos;
+    uint64_t offSlots;
+    uint64_t qtdDivergenciasCnpj;
+    uint64_t qtdDivergenciasPeso;
+    uint64_t offDivergenciasCnpj;
+    uint64_t offDivergenciasPeso;
+    uint64_t tamanho;
+} CabecalhoEstado;
+
+// Estado mapeado em memória compartilhada: as alterações vão direto para o arquivo
+typedef struct
+{
+    void *base;
+    size_t tamanho;
+    CabecalhoEstado *cab;
+    ContainerArray originais;
+    ContainerArray observados;
+    unsigned char *estados;
+    int *correspondencia;
+    int *divergenciasCnpj;
+    int *divergenciasPeso;
+    TabelaHash indice;
+} EstadoAuditoria;
+
+// Busca binária do primeiro observado com o código (os observados do estado estão ordenados)
+int buscarBinariaContainer(ContainerArray *observados, uint64_t codigo)
+{
+    // Inicializa os índices de busca
+    int menor = 0, maior = observados->qtd;
+    // Realiza a busca binária pelo limite inferior
+    while (menor < maior)
+    {
+        int mid = menor + (maior - menor) / 2;
+        if (observados->codigos[mid] < codigo) menor = mid + 1;
+        else maior = mid;
+    }
+    return menor < observados->qtd && observados->codigos[menor] == codigo ? menor : -1;
+}
+
+// Função que calcula os bits de divergência de um original contra o observado correspondente
+unsigned char calcularEstado(ContainerArray *originais, int i, ContainerArray *observados, int idx)
+{
+    if (idx == -1) return 0;
+    if (originais->cnpjs[i] != observados->cnpjs[idx]) return DIVERGENCIA_CNPJ;
+    int diferenca;
+    double percentual;
+    return pesoDiverge(originais->pesos[i], observados->pesos[idx], &diferenca, &percentual) ? DIVERGENCIA_PESO : 0;
+}
+
+// Função que indica se o container entra no relatório pela divergência do bit
+int noRelatorio(unsigned char estado, unsigned char bit)
+{
+    return (estado & bit) && !(estado & CONTAINER_REMOVIDO);
+}
+
+// Função para gravar o estado da auditoria em lote; retorna 0 em caso de erro
+int escreverEstado(ContainerArray *originais, ContainerArray *observados, int *correspondencia, FILE *arquivo, int threads)
+{
+    uint64_t n = (uint64_t)originais->qtd, m = (uint64_t)observados->qtd;
+    // Folga de 25% para containers incluídos por revisões futuras
+    uint64_t cap = n + n / 4 + 1024;
+
+    // Ordena os observados e converte as correspondências para as novas posições
+    ParChave *pares = ordenarPares(observados->codigos, observados->qtd, ORDENACAO_RADIX, threads);
+    ContainerArray ordenados = alocarContainers(observados->qtd);
+    int *novaPosicao = malloc(sizeof(int) * (m > 0 ? m : 1));
+    int *correspondenciaOrdenada = malloc(sizeof(int) * (n > 0 ? n : 1));
+    unsigned char *estados = malloc(n > 0 ? n : 1);
+    int *divergenciasCnpj = malloc(sizeof(int) * (n > 0 ? n : 1));
+    int *divergenciasPeso = malloc(sizeof(int) * (n > 0 ? n : 1));
+    uint64_t qtdCnpj = 0, qtdPeso = 0;
+    TabelaHash tabela = criarTabelaHash(cap);
+    int ok = pares && ordenados.codigos && novaPosicao && correspondenciaOrdenada && estados && divergenciasCnpj
+             && divergenciasPeso && tabela.slots;
+    if (ok)
+    {
+        for (uint64_t k = 0; k < m; k++)
+        {
+            uint32_t origem = pares[k].indice;
+            ordenados.codigos[k] = pares[k].chave;
+            ordenados.cnpjs[k] = observados->cnpjs[origem];
+            ordenados.pesos[k] = observados->pesos[origem];
+            novaPosicao[origem] = (int)k;
+        }
+        for (uint64_t i = 0; i < n; i++)
+        {
+            int idx = correspondencia[i];
+            correspondenciaOrdenada[i] = idx == -1 ? -1 : novaPosicao[idx];
+            estados[i] = calcularEstado(originais, (int)i, observados, idx);
+            if (estados[i] & DIVERGENCIA_CNPJ) divergenciasCnpj[qtdCnpj++] = (int)i;
+            if (estados[i] & DIVERGENCIA_PESO) divergenciasPeso[qtdPeso++] = (int)i;
+            inserirTabelaHash(&tabela, originais, (int)i);
+        }
+
+        // Calcula o deslocamento de cada região (vetores dos originais dimensionados pela capacidade)
+        CabecalhoEstado cab;
+        memset(&cab, 0, sizeof(cab));
+        memcpy(cab.magica, MAGICA_ESTADO, 8);
+        cab.versao = VERSAO_ESTADO;
+        cab.qtdOriginais = n;
+        cab.capOriginais = cap;
+        cab.qtdObservados = m;
+        cab.capacidadeHash = tabela.mascara + 1;
+        cab.offCodigos = alinhar8(sizeof(CabecalhoEstado));
+        cab.offCnpjs = alinhar8(cab.offCodigos + cap * sizeof(uint64_t));
+        cab.offPesos = alinhar8(cab.offCnpjs + cap * sizeof(uint64_t));
+        cab.offEstados = alinhar8(cab.offPesos + cap * sizeof(int));
+        cab.offCorrespondencia = alinhar8(cab.offEstados + cap);
+        cab.offObsCodigos = alinhar8(cab.offCorrespondencia + cap * sizeof(int));
+        cab.offObsCnpjs = alinhar8(cab.offObsCodigos + m * sizeof(uint64_t));
+        cab.offObsPesos = alinhar8(cab.offObsCnpjs + m * sizeof(uint64_t));
+        cab.offSlots = alinhar8(cab.offObsPesos + m * sizeof(int));
+        cab.qtdDivergenciasCnpj = qtdCnpj;
+        cab.qtdDivergenciasPeso = qtdPeso;
+        cab.offDivergenciasCnpj = alinhar8(cab.offSlots + cab.capacidadeHash * sizeof(int));
+        cab.offDivergenciasPeso = alinhar8(cab.offDivergenciasCnpj + cap * sizeof(int));
+        cab.tamanho = cab.offDivergenciasPeso + cap * sizeof(int);
+
+        // Grava cabeçalho e regiões em sequência (a folga é preenchida com zeros)
+        fwrite(&cab, sizeof(cab), 1, arquivo);
+        escreverRegiao(arquivo, cab.offCodigos, originais->codigos, n * sizeof(uint64_t));
+        escreverRegiao(arquivo, cab.offCnpjs, originais->cnpjs, n * sizeof(uint64_t));
+        escreverRegiao(arquivo, cab.offPesos, originais->pesos, n * sizeof(int));
+        escreverRegiao(arquivo, cab.offEstados, estados, n);
+        escreverRegiao(arquivo, cab.offCorrespondencia, correspondenciaOrdenada, n * sizeof(int));
+        escreverRegiao(arquivo, cab.offObsCodigos, ordenados.codigos, m * sizeof(uint64_t));
+        escreverRegiao(arquivo, cab.offObsCnpjs, ordenados.cnpjs, m * sizeof(uint64_t));
+        escreverRegiao(arquivo, cab.offObsPesos, ordenados.pesos, m * sizeof(int));
+        escreverRegiao(arquivo, cab.offSlots, tabela.slots, cab.capacidadeHash * sizeof(int));
+        escreverRegiao(arquivo, cab.offDivergenciasCnpj, divergenciasCnpj, qtdCnpj * sizeof(int));
+        escreverRegiao(arquivo, cab.offDivergenciasPeso, divergenciasPeso, qtdPeso * sizeof(int));
+        // Completa com zeros a folga da última lista
+        escreverRegiao(arquivo, cab.tamanho, NULL, 0);
+        ok = !ferror(arquivo);
+    }
+    free(pares);
+    liberarContainers(&ordenados);
+    free(novaPosicao);
+    free(correspondenciaOrdenada);
+    free(estados);
+    free(divergenciasCnpj);
+    free(divergenciasPeso);
+    free(tabela.slots);
+    return ok;
+}
+
+// Função para mapear um estado de auditoria para leitura e escrita; retorna 0 em caso de erro
+int abrirEstado(const char *caminho, EstadoAuditoria *e)
+{
+    int fd = open(caminho, O_RDWR);
+    if (fd < 0) return 0;
+    struct stat info;
+    if (fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(CabecalhoEstado))
+    {
+        close(fd);
+        return 0;
+    }
+    void *base = mmap(NULL, (size_t)info.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) return 0;
+
+    // Valida assinatura, versão e limites das regiões
+    CabecalhoEstado *cab = base;
+    if (memcmp(cab->magica, MAGICA_ESTADO, 8) != 0 || cab->versao != VERSAO_ESTADO
+        || cab->tamanho != (uint64_t)info.st_size || cab->capOriginais > INT32_MAX
+        || cab->qtdOriginais > cab->capOriginais || cab->qtdObservados > INT32_MAX
+        || cab->capacidadeHash < cab->capOriginais * 2 || (cab->capacidadeHash & (cab->capacidadeHash - 1)) != 0
+        || cab->offCnpjs < cab->offCodigos + cab->capOriginais * sizeof(uint64_t)
+        || cab->offPesos < cab->offCnpjs + cab->capOriginais * sizeof(uint64_t)
+        || cab->offEstados < cab->offPesos + cab->capOriginais * sizeof(int)
+        || cab->offCorrespondencia < cab->offEstados + cab->capOriginais
+        || cab->offObsCodigos < cab->offCorrespondencia + cab->capOriginais * sizeof(int)
+        || cab->offObsCnpjs < cab->offObsCodigos + cab->qtdObservados * sizeof(uint64_t)
+        || cab->offObsPesos < cab->offObsCnpjs + cab->qtdObservados * sizeof(uint64_t)
+        || cab->offSlots < cab->offObsPesos + cab->qtdObservados * sizeof(int)
+        || cab->offDivergenciasCnpj < cab->offSlots + cab->capacidadeHash * sizeof(int)
+        || cab->offDivergenciasPeso < cab->offDivergenciasCnpj + cab->capOriginais * sizeof(int)
+        || cab->tamanho < cab->offDivergenciasPeso + cab->capOriginais * sizeof(int)
+        || cab->qtdDivergenciasCnpj > cab->qtdOriginais || cab->qtdDivergenciasPeso > cab->qtdOriginais)
+    {
+        fprintf(stderr, "Estado de auditoria inválido ou de versão incompatível.\n");
+        munmap(base, (size_t)info.st_size);
+        return 0;
+    }
+
+    // Aponta as estruturas para a região mapeada
+    char *bytes = base;
+    e->base = base;
+    e->tamanho = (size_t)info.st_size;
+    e->cab = cab;
+    e->originais.codigos = (uint64_t *)(bytes + cab->offCodigos);
+    e->originais.cnpjs = (uint64_t *)(bytes + cab->offCnpjs);
+    e->originais.pesos = (int *)(bytes + cab->offPesos);
+    e->originais.temDivergenciaCNPJ = NULL;
+    e->originais.qtd = (int)cab->qtdOriginais;
+    e->estados = (unsigned char *)(bytes + cab->offEstados);
+    e->correspondencia = (int *)(bytes + cab->offCorrespondencia);
+    e->divergenciasCnpj = (int *)(bytes + cab->offDivergenciasCnpj);
+    e->divergenciasPeso = (int *)(bytes + cab->offDivergenciasPeso);
+    e->observados.codigos = (uint64_t *)(bytes + cab->offObsCodigos);
+    e->observados.cnpjs = (uint64_t *)(bytes + cab->offObsCnpjs);
+    e->observados.pesos = (int *)(bytes + cab->offObsPesos);
+    e->observados.temDivergenciaCNPJ = NULL;
+    e->observados.qtd = (int)cab->qtdObservados;
+    e->indice.slots = (int *)(bytes + cab->offSlots);
+    e->indice.mascara = cab->capacidadeHash - 1;
+    return 1;
+}
+
+// Containers alterados por uma revisão, cada um registrado uma vez só
+typedef struct
+{
+    int *indices;
+    size_t qtd;
+    size_t cap;
+} ListaAlterados;
+
+// Função que grava o novo estado de um container e o registra entre os alterados da revisão;
+// retorna 0 (sem alterar nada) em caso de erro de alocação
+int alterarEstado(EstadoAuditoria *e, ListaAlterados *alterados, int i, unsigned char estado)
+{
+    if (!(e->estados[i] & ESTADO_ALTERADO))
+    {
+        // Cresce a lista quando necessário
+        if (alterados->qtd == alterados->cap)
+        {
+            size_t novaCap = alterados->cap ? alterados->cap * 2 : 256;
+            int *indices = realloc(alterados->indices, sizeof(int) * novaCap);
+            if (!indices)
+            {
+                fprintf(stderr, "Erro de alocação ao aplicar a revisão.\n");
+                return 0;
             }
-            // Calcula o percentual da diferença
-            double percentual = round((double)diferenca / (double)pesoOriginal * 100.0);
+            alterados->indices = indices;
+            alterados->cap = novaCap;
+        }
+        alterados->indices[alterados->qtd++] = i;
+    }
+    e->estados[i] = estado | ESTADO_ALTERADO;
+    return 1;
+}
+
+// Função de comparação de índices para o qsort
+int compararIndices(const void *a, const void *b)
+{
+    int x = *(const int *)a, y = *(const int *)b;
+    return (x > y) - (x < y);
+}
+
+// Procedimento que atualiza uma lista ordenada de divergências com os containers alterados (ordenados):
+// tira da lista os alterados e reinsere os que ainda divergem pelo bit, sem memória extra.
+// Custa O(lista + alterados), a mesma ordem das linhas que o relatório escreve
+void atualizarDivergencias(EstadoAuditoria *e, int *lista, uint64_t *qtd, ListaAlterados *alterados, unsigned char bit)
+{
+    // Compacta a lista para a frente, descartando os alterados
+    uint64_t mantidos = 0;
+    for (uint64_t k = 0; k < *qtd; k++)
+        if (!(e->estados[lista[k]] & ESTADO_ALTERADO)) lista[mantidos++] = lista[k];
+    uint64_t inseridos = 0;
+    for (size_t k = 0; k < alterados->qtd; k++)
+        inseridos += noRelatorio(e->estados[alterados->indices[k]], bit);
 
-            // Se o percentual for maior que 10.0%, escreve no arquivo de saída
-            if (percentual > 10.0)
+    // Intercala de trás para a frente os alterados que divergem (a lista só cresce)
+    int64_t a = (int64_t)mantidos - 1, b = (int64_t)alterados->qtd - 1;
+    uint64_t w = mantidos + inseridos;
+    *qtd = w;
+    while (b >= 0)
+    {
+        int i = alterados->indices[b];
+        if (!noRelatorio(e->estados[i], bit)) b--;
+        else if (a >= 0 && lista[a] > i) lista[--w] = lista[a--];
+        else
+        {
+            lista[--w] = i;
+            b--;
+        }
+    }
+}
+
+// Função que aplica uma revisão do manifesto declarado ("+ código cnpj peso" inclui/altera, "- código" remove);
+// só os containers alterados são reavaliados e movidos nas listas de divergência. Retorna a quantidade de linhas
+// aplicadas ou -1 em caso de erro (as linhas anteriores ao erro ficam aplicadas)
+long aplicarDelta(EstadoAuditoria *e, FILE *diff)
+{
+    char linha[256], op[4], texto[MAX_CODE_LENGTH], cnpjTexto[MAX_CNPJ_LENGTH];
+    long aplicadas = 0, numero = 0;
+    ListaAlterados alterados = {NULL, 0, 0};
+    while (fgets(linha, sizeof(linha), diff))
+    {
+        numero++;
+        if (linha[0] == '\n') continue;
+        int peso = 0;
+        uint64_t codigo, cnpj = 0;
+        int campos = sscanf(linha, "%3s %31s %31s %d", op, texto, cnpjTexto, &peso);
+        int inclusao = strcmp(op, "+") == 0;
+        // Valida o formato conforme a operação
+        if (campos < 2 || (!inclusao && strcmp(op, "-") != 0) || (inclusao && campos != 4)
+            || !codificarCodigo(texto, &codigo) || (inclusao && !codificarCNPJ(cnpjTexto, &cnpj)))
+        {
+            fprintf(stderr, "Linha de revisão inválida (%ld).\n", numero);
+            continue;
+        }
+
+        int i = buscarTabelaHash(&e->indice, &e->originais, codigo);
+        if (!inclusao)
+        {
+            // Remoção: o registro permanece para futuras reinclusões, mas sai do relatório
+            if (i != -1 && !alterarEstado(e, &alterados, i, CONTAINER_REMOVIDO))
+            {
+                aplicadas = -1;
+                break;
+            }
+            aplicadas++;
+            continue;
+        }
+        if (i == -1)
+        {
+            // Inclusão no final do manifesto, dentro da folga reservada
+            if ((uint64_t)e->originais.qtd == e->cab->capOriginais)
+            {
+                fprintf(stderr, "Capacidade do estado esgotada; refaça a auditoria completa.\n");
+                aplicadas = -1;
+                break;
+            }
+            i = e->originais.qtd;
+            if (!alterarEstado(e, &alterados, i, 0))
             {
-                fprintf(output, "%s:%dkg(%.0f%%)\n",  originais->containers[i].codigo,
-                                                    diferenca,
-                                                    round(percentual));
+                aplicadas = -1;
+                break;
             }
+            e->originais.qtd++;
+            e->cab->qtdOriginais = (uint64_t)e->originais.qtd;
+            e->originais.codigos[i] = codigo;
+            inserirTabelaHash(&e->indice, &e->originais, i);
         }
+        // Atualiza o registro e reavalia apenas este container
+        e->originais.cnpjs[i] = cnpj;
+        e->originais.pesos[i] = peso;
+        e->correspondencia[i] = buscarBinariaContainer(&e->observados, codigo);
+        if (!alterarEstado(e, &alterados, i, calcularEstado(&e->originais, i, &e->observados, e->correspondencia[i])))
+        {
+            aplicadas = -1;
+            break;
+        }
+        aplicadas++;
     }
+
+    // Move os alterados nas listas de divergência e limpa as marcas temporárias
+    if (alterados.qtd > 0)
+    {
+        qsort(alterados.indices, alterados.qtd, sizeof(int), compararIndices);
+        atualizarDivergencias(e, e->divergenciasCnpj, &e->cab->qtdDivergenciasCnpj, &alterados, DIVERGENCIA_CNPJ);
+        atualizarDivergencias(e, e->divergenciasPeso, &e->cab->qtdDivergenciasPeso, &alterados, DIVERGENCIA_PESO);
+        for (size_t k = 0; k < alterados.qtd; k++)
+            e->estados[alterados.indices[k]] &= (unsigned char)~ESTADO_ALTERADO;
+    }
+    free(alterados.indices);
+    return aplicadas;
+}
+
+// Procedimento para escrever o relatório a partir das listas de divergência, sem refazer comparações
+// nem percorrer o manifesto: primeiro as divergências de CNPJ, depois as de peso, na ordem do manifesto
+void escreverRelatorioEstado(EstadoAuditoria *e, FILE *output)
+{
+    char codigo[12], cnpjOriginal[19], cnpjObservado[19];
+    for (uint64_t k = 0; k < e->cab->qtdDivergenciasCnpj; k++)
+    {
+        int i = e->divergenciasCnpj[k], idx = e->correspondencia[i];
+        decodificarCodigo(e->originais.codigos[i], codigo);
+        decodificarCNPJ(e->originais.cnpjs[i], cnpjOriginal);
+        decodificarCNPJ(e->observados.cnpjs[idx], cnpjObservado);
+        fprintf(output, "%s:%s<->%s\n", codigo, cnpjOriginal, cnpjObservado);
+    }
+    for (uint64_t k = 0; k < e->cab->qtdDivergenciasPeso; k++)
+    {
+        int i = e->divergenciasPeso[k], idx = e->correspondencia[i];
+        int diferenca;
+        double percentual = 0;
+        decodificarCodigo(e->originais.codigos[i], codigo);
+        pesoDiverge(e->originais.pesos[i], e->observados.pesos[idx], &diferenca, &percentual);
+        fprintf(output, "%s:%dkg(%.0f%%)\n", codigo, diferenca, round(percentual));
+    }
+}
+
+// Função para ler as opções a partir do terceiro argumento; retorna 0 se alguma for inválida
+int lerOpcoes(int argc, char *argv[], Configuracao *cfg)
+{
+    for (int a = 3; a < argc; a++)
+    {
+        const char *opcao = argv[a];
+        // A estratégia de junção também é aceita na forma posicional original (terceiro argumento)
+        if (strcmp(opcao, "--juncao=auto") == 0 || (a == 3 && strcmp(opcao, "auto") == 0)) cfg->juncao = JUNCAO_AUTO;
+        else if (strcmp(opcao, "--juncao=hash") == 0 || (a == 3 && strcmp(opcao, "hash") == 0)) cfg->juncao = JUNCAO_HASH;
+        else if (strcmp(opcao, "--juncao=merge") == 0 || (a == 3 && strcmp(opcao, "merge") == 0)) cfg->juncao = JUNCAO_MERGE;
+        else if (strcmp(opcao, "--ordenacao=radix") == 0) cfg->ordenacao = ORDENACAO_RADIX;
+        else if (strcmp(opcao, "--ordenacao=merge") == 0) cfg->ordenacao = ORDENACAO_MERGE;
+        else if (strncmp(opcao, "--threads=", 10) == 0 && atoi(opcao + 10) > 0) cfg->threads = atoi(opcao + 10);
+        else if (strcmp(opcao, "--stream") == 0) cfg->fonteStream = "-";
+        else if (strncmp(opcao, "--stream=", 9) == 0 && opcao[9]) cfg->fonteStream = opcao + 9;
+        else if (strncmp(opcao, "--bench-stream=", 15) == 0 && atol(opcao + 15) > 0) cfg->benchStream = atol(opcao + 15);
+        else if (strncmp(opcao, "--snapshot=", 11) == 0 && opcao[11]) cfg->snapshot = opcao + 11;
+        else if (strcmp(opcao, "--compilar") == 0) cfg->compilar = 1;
+        else if (strcmp(opcao, "--consultas") == 0) cfg->consultas = "-";
+        else if (strncmp(opcao, "--consultas=", 12) == 0 && opcao[12]) cfg->consultas = opcao + 12;
+        else if (strncmp(opcao, "--salvar-estado=", 16) == 0 && opcao[16]) cfg->salvarEstado = opcao + 16;
+        else if (strncmp(opcao, "--delta=", 8) == 0 && opcao[8]) cfg->delta = opcao + 8;
+        else
+        {
+            printf("Opção inválida: %s\n", opcao);
+            return 0;
+        }
+    }
+    return 1;
 }
 
 // Função principal com argumentos de linha de comando
 int main(int argc, char* argv[])
 {
     // Verificação dos argumentos
-    if (argc != 3)
+    if (argc < 3)
     {
-        printf("Uso: %s <arquivo_entrada> <arquivo_saida>\n", argv[0]);
+        printf("Uso: %s <arquivo_entrada> <arquivo_saida> [auto|hash|merge] [opções]\n", argv[0]);
+        printf("Opções: --juncao=auto|hash|merge --ordenacao=radix|merge --threads=N\n");
+        printf("        --stream[=fifo] --bench-stream=N\n");
+        printf("        --compilar (grava o snapshot do manifesto declarado em <arquivo_saida>)\n");
+        printf("        --snapshot=arquivo (manifesto declarado pré-compilado; a entrada traz só os observados)\n");
+        printf("        --consultas[=arquivo] (\"top K\" / \"acima P\" por linha; respostas na saída padrão)\n");
+        printf("        --salvar-estado=arquivo (grava o estado da auditoria para o modo delta)\n");
+        printf("        --delta=estado (a entrada traz a revisão: \"+ código cnpj peso\" ou \"- código\")\n");
         printf("Exemplo: %s input.txt output.txt\n", argv[0]);
         return 1;
     }
 
-    // Abrindo arquivos
-    FILE* input = fopen(argv[1], "r");
-    FILE* output = fopen(argv[2], "w");
+    // Configuração padrão: junção automática, radix sort com uma thread por núcleo
+    Configuracao cfg = {JUNCAO_AUTO, ORDENACAO_RADIX, (int)sysconf(_SC_NPROCESSORS_ONLN), NULL, 0, NULL, 0, NULL, NULL, NULL};
+    if (cfg.threads < 1) cfg.threads = 1;
+    if (!lerOpcoes(argc, argv, &cfg)) return 1;
+    int modoStream = cfg.fonteStream || cfg.benchStream;
+
+    // Modo delta: aplica a revisão sobre o estado salvo e reescreve o relatório
+    if (cfg.delta)
+    {
+        EstadoAuditoria estado;
+        FILE* diff = fopen(argv[1], "r");
+        FILE* output = fopen(argv[2], "w");
+        if (!diff || !output || !abrirEstado(cfg.delta, &estado))
+        {
+            printf("Erro ao abrir arquivos.\n");
+            return 1;
+        }
+        long aplicadas = aplicarDelta(&estado, diff);
+        if (aplicadas >= 0) escreverRelatorioEstado(&estado, output);
+        msync(estado.base, estado.tamanho, MS_SYNC);
+        munmap(estado.base, estado.tamanho);
+        fclose(diff);
+        fclose(output);
+        return aplicadas < 0;
+    }
+
+    // Abrindo arquivos (com snapshot, o modo contínuo não precisa do arquivo de entrada)
+    FILE* input = (cfg.snapshot && modoStream) ? NULL : fopen(argv[1], "r");
+    FILE* output = fopen(argv[2], cfg.compilar ? "wb" : "w");
+    if ((!input && !(cfg.snapshot && modoStream)) || !output)
+    {
+        printf("Erro ao abrir arquivos.\n");
+        return 1;
+    }
+
+    // Manifesto declarado: mapeado do snapshot ou lido do arquivo de entrada
+    ContainerArray dadosOriginais = {NULL, NULL, NULL, NULL, 0};
+    int rejeitados = 0;
+    TabelaHash indiceOriginais = {NULL, 0};
+    Snapshot snap = {NULL, 0};
+    if (cfg.snapshot)
+    {
+        if (!abrirSnapshot(cfg.snapshot, &snap, &dadosOriginais, &indiceOriginais))
+        {
+            printf("Erro ao abrir snapshot %s.\n", cfg.snapshot);
+            return 1;
+        }
+    } else dadosOriginais = lerDados(input, &rejeitados);
+    if (!dadosOriginais.codigos)
+    {
+        printf("Erro ao ler o manifesto declarado.\n");
+        if (input) fclose(input);
+        fclose(output);
+        return 1;
+    }
+
+    // Registros descartados tornam o status de saída diferente de zero
+    int status = rejeitados > 0;
+    if (cfg.compilar)
+    {
+        // Compila o manifesto declarado em snapshot binário
+        if (!escreverSnapshot(&dadosOriginais, output))
+        {
+            printf("Erro ao gravar snapshot.\n");
+            status = 1;
+        }
+    } else if (modoStream)
+    {
+        // Modo contínuo: o índice do manifesto declarado é construído uma única vez (ou vem do snapshot)
+        if (!indiceOriginais.slots) indiceOriginais = construirTabelaHash(&dadosOriginais);
+        if (cfg.benchStream) benchmarkStream(&dadosOriginais, &indiceOriginais, cfg.benchStream, output);
+        else
+        {
+            FILE *fonte = strcmp(cfg.fonteStream, "-") == 0 ? stdin : fopen(cfg.fonteStream, "r");
+            if (!fonte)
+            {
+                printf("Erro ao abrir fonte de observações.\n");
+                status = 1;
+            } else
+            {
+                auditarStream(&dadosOriginais, &indiceOriginais, fonte, output);
+                if (fonte != stdin) fclose(fonte);
+            }
+        }
+        if (!snap.base) free(indiceOriginais.slots);
+    } else
+    {
+        int rejeitadosObservados;
+        ContainerArray dadosObservados = lerDados(input, &rejeitadosObservados);
+        if (rejeitadosObservados > 0) status = 1;
 
-    // Leitura dos dados dos arquivos
-    ContainerArray dadosOriginais = lerDados(input);
-    ContainerArray dadosObservados = lerDados(input);
+        // Escolhe a junção pelo tamanho do lado indexado
+        if (cfg.juncao == JUNCAO_AUTO)
+            cfg.juncao = dadosObservados.qtd <= LIMITE_JUNCAO_HASH || snap.base ? JUNCAO_HASH : JUNCAO_MERGE;
 
-    // Ordena somente o array de observados
-    if (dadosObservados.qtd > 0) mergesortContainers(dadosObservados.containers, dadosObservados.qtd);
+        // Associa cada container original ao observado de mesmo código
+        int *correspondencia = NULL;
+        if (dadosObservados.codigos)
+        {
+            if (cfg.juncao == JUNCAO_HASH)
+                correspondencia = snap.base ? juntarHashIndiceOriginais(&dadosOriginais, &indiceOriginais, &dadosObservados)
+                                            : juntarHash(&dadosOriginais, &dadosObservados);
+            else correspondencia = juntarSortMerge(&dadosOriginais, &dadosObservados, &cfg);
+        }
 
-    // Passando o arquivo de saída para as funções
-    compararCNPJs(&dadosOriginais, &dadosObservados, output);
-    compararPesos(&dadosOriginais, &dadosObservados, output);
+        if (!dadosObservados.codigos)
+        {
+            printf("Erro ao ler o manifesto observado.\n");
+            status = 1;
+        } else if (!correspondencia)
+        {
+            fprintf(stderr, "Erro de alocação na junção.\n");
+            status = 1;
+        } else
+        {
+            // Passando o arquivo de saída para a auditoria
+            auditarContainersParalelo(&dadosOriginais, &dadosObservados, correspondencia, output, cfg.threads);
+
+            // Estado para auditorias delta das próximas revisões
+            if (cfg.salvarEstado)
+            {
+                FILE *arquivoEstado = fopen(cfg.salvarEstado, "wb");
+                if (!arquivoEstado || !escreverEstado(&dadosOriginais, &dadosObservados, correspondencia, arquivoEstado, cfg.threads))
+                {
+                    printf("Erro ao gravar estado da auditoria.\n");
+                    status = 1;
+                }
+                if (arquivoEstado) fclose(arquivoEstado);
+            }
+
+            // Consultas de desvio respondidas sobre o armazém, sem refazer a junção
+            if (cfg.consultas)
+            {
+                FILE *fonte = strcmp(cfg.consultas, "-") == 0 ? stdin : fopen(cfg.consultas, "r");
+                ArmazemDesvios armazem = construirArmazemDesvios(&dadosOriginais, &dadosObservados, correspondencia);
+                if (!fonte || !armazem.itens)
+                {
+                    printf("Erro ao preparar consultas.\n");
+                    status = 1;
+                } else responderConsultas(&armazem, &dadosOriginais, fonte, stdout);
+                if (fonte && fonte != stdin) fclose(fonte);
+                free(armazem.itens);
+                free(armazem.ordenados);
+            }
+            free(correspondencia);
+        }
+        liberarContainers(&dadosObservados);
+    }
 
     // Fechando arquivos
-    fclose(input);
+    if (input) fclose(input);
     fclose(output);
 
-    // Liberando memória alocada
-    free(dadosOriginais.containers);
-    free(dadosObservados.containers);
-    
+    // Liberando memória alocada (o snapshot é apenas desmapeado)
+    if (snap.base) munmap(snap.base, snap.tamanho);
+    else liberarContainers(&dadosOriginais);
+
     // Finalizando o programa
-    return 0;
-}
\ No newline at end of file
+    return status;
+}
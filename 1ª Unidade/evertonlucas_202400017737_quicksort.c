@@ -2,11 +2,29 @@
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <time.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#include <sched.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <errno.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define TEM_X86 1
+#endif
+#include "quickSortGenerico.h"
 
 typedef struct
 {
     char nome[3];
-    int custo;
+    long long custo;
 } MetodoResultado;
 
 typedef struct
@@ -19,23 +37,236 @@ typedef struct
 {
     Array *arrays;
     int qtdArrays;
+    // Entrada binária mapeada: os arrays apontam para ela (NULL = arrays alocados)
+    void *mapa;
+    size_t tamanhoMapa;
 } SetArrays;
 
-// Estrutura para estatísticas
+// Contadores de hardware lidos via perf_event_open
+enum { CONT_CICLOS, CONT_INSTRUCOES, CONT_FALHAS_DESVIO, CONT_FALHAS_L1, CONT_FALHAS_LLC, QTD_CONTADORES };
+
+// Medição completa de um par (array, método) no modo instrumentado
+typedef struct
+{
+    Estatisticas stats;
+    long long ns;
+    // -1 quando o contador não está disponível no sistema
+    long long contadores[QTD_CONTADORES];
+} Medicao;
+
+// Métodos de partição disponíveis (códigos 1..QTD_METODOS, índices das tabelas de ordenadores);
+// a partir do código 13 o nome é esquema (L, H, B, T, D de duplo pivô) + política de pivô:
+// R aleatório (PCG semeado), N ninther, S mediana de amostra sqrt(n), D mediana exata (BFPRT).
+// PD e VM não têm variantes: o pivô do híbrido faz parte da sua adaptação e o VM é int32
+#define QTD_METODOS 32
+// Nome de cada método na ordem dos códigos
+static const char nomesMetodos[QTD_METODOS][3] = {"LP", "LM", "LA", "HP", "HM", "HA", "BM", "BA", "TV", "DP", "VM", "PD",
+                                                   "LR", "LN", "LS", "LD", "HR", "HN", "HS", "HD",
+                                                   "BR", "BN", "BS", "BD", "TR", "TN", "TS", "TD",
+                                                   "DR", "DN", "DS", "DD"};
+
+// Métodos avaliados em cada array, na ordem de desempate do ranking
+typedef struct
+{
+    int codigos[QTD_METODOS];
+    int qtd;
+    // Seleção feita por "todos" (fora de int32 ela deixa de fora o VM, que só existe para int)
+    int todos;
+} SelecaoMetodos;
+
+// Configuração da execução (opções de linha de comando)
 typedef struct
 {
-    int trocas;
-    int chamadas;
-} Estatisticas;
+    int threads;
+    SelecaoMetodos metodos;
+    const char *metricasCsv;
+    const char *metricasJson;
+    // Tamanho dos arrays do benchmark de poucos valores distintos (0 = desligado)
+    int benchDuplicados;
+    // Modo paralelo: cada array é ordenado por todas as threads (em vez de pares em paralelo)
+    int paralelo;
+    // Kernel vetorial forçado ("avx512", "avx2", "escalar"; NULL = detecção por CPUID)
+    const char *kernel;
+    // Tipo das chaves da entrada ("int64", "double", ...; NULL = int32)
+    const char *tipo;
+    // Formato de destino da conversão ("binario" ou "texto"; NULL = avaliação normal)
+    const char *converter;
+    // Modo streaming: um array por vez na memória, com leitura sobreposta à avaliação
+    int streaming;
+    // Memória do modo externo em bytes (0 = desligado), arquivo binário dos arrays
+    // ordenados (NULL = só o ranking) e pasta dos temporários (NULL = $TMPDIR ou /tmp)
+    size_t memoriaExterna;
+    const char *ordenado;
+    const char *pastaTemporaria;
+    // Modo estimador: 1 = ranking pelo custo estimado, 2 = validação contra o exato
+    int estimar;
+} Configuracao;
+
+// Arquivo de entrada mapeado em memória, lido com um cursor
+typedef struct
+{
+    const char *dados;
+    size_t tamanho;
+    size_t pos;
+} Entrada;
+
+// Formato binário: cabeçalho, tamanhos dos arrays (int32) e, a partir de offDados
+// (alinhado em 8), os elementos de todos os arrays em sequência; tudo little-endian
+#define MAGICA_BINARIO "QUICKBIN"
+#define VERSAO_BINARIO 1
+
+typedef struct
+{
+    char magica[8];
+    uint32_t versao;
+    uint32_t qtdArrays;
+    uint64_t offDados;
+    uint64_t tamanho;
+} CabecalhoBinario;
+
+// Função que arredonda um deslocamento para múltiplo de 8
+uint64_t alinhar8(uint64_t off)
+{
+    return (off + 7) & ~(uint64_t)7;
+}
+
+// Função para mapear o arquivo de entrada só para leitura; retorna 0 em caso de erro
+int abrirEntrada(const char *caminho, Entrada *e)
+{
+    e->dados = NULL;
+    e->tamanho = 0;
+    e->pos = 0;
+    int fd = open(caminho, O_RDONLY);
+    if (fd < 0) return 0;
+    struct stat info;
+    if (fstat(fd, &info) != 0)
+    {
+        close(fd);
+        return 0;
+    }
+    // Arquivo vazio: nada a mapear
+    if (info.st_size > 0)
+    {
+        void *base = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (base == MAP_FAILED)
+        {
+            close(fd);
+            return 0;
+        }
+        // A leitura é sequencial
+        madvise(base, (size_t)info.st_size, MADV_SEQUENTIAL);
+        e->dados = base;
+        e->tamanho = (size_t)info.st_size;
+    }
+    close(fd);
+    return 1;
+}
+
+// Procedimento para desfazer o mapeamento da entrada
+void fecharEntrada(Entrada *e)
+{
+    if (e->dados)
+        munmap((void *)e->dados, e->tamanho);
+    e->dados = NULL;
+    e->tamanho = 0;
+}
+
+// Função que indica se a entrada está no formato binário
+int entradaBinaria(const Entrada *e)
+{
+    return e->tamanho >= sizeof(CabecalhoBinario) && memcmp(e->dados, MAGICA_BINARIO, 8) == 0;
+}
+
+// Função que converte 8 dígitos ASCII (o primeiro no byte menos significativo)
+// com três multiplicações, combinando pares, quartetos e octetos de dígitos
+static inline uint32_t converterOitoDigitos(uint64_t x)
+{
+    x = ((x & 0x0F0F0F0F0F0F0F0FULL) * 2561) >> 8;
+    x = ((x & 0x00FF00FF00FF00FFULL) * 6553601) >> 16;
+    return (uint32_t)(((x & 0x0000FFFF0000FFFFULL) * 42949672960001ULL) >> 32);
+}
+
+// Função que conta os dígitos no início de uma palavra de 8 bytes (SWAR): cada
+// byte tem o bit alto ligado se está em '0'..'9', sem vai-um entre os bytes
+static inline int contarDigitos(uint64_t x)
+{
+    uint64_t baixo = x & 0x7F7F7F7F7F7F7F7FULL;
+    uint64_t digitos = (baixo + 0x5050505050505050ULL) & ~(baixo + 0x4646464646464646ULL) & ~x & 0x8080808080808080ULL;
+    uint64_t outros = ~digitos & 0x8080808080808080ULL;
+    return outros ? __builtin_ctzll(outros) / 8 : 8;
+}
+
+// Função que lê o próximo inteiro decimal da entrada de texto (mesmo formato de
+// fscanf("%d"): espaços, sinal opcional e dígitos, com valores fora do alcance
+// saturados em long long e truncados para int como na glibc); devolve 0 sem
+// avançar se não há inteiro, de modo que as leituras seguintes também falham. Os
+// dígitos são consumidos de 8 em 8 com SWAR enquanto há 8 bytes mapeados à frente
+int lerInteiro(Entrada *e, int *valor)
+{
+    const char *p = e->dados + e->pos;
+    const char *fim = e->dados + e->tamanho;
+    while (p < fim && (*p == ' ' || (*p >= '\t' && *p <= '\r')))
+        p++;
+    int negativo = 0;
+    if (p < fim && (*p == '-' || *p == '+'))
+        negativo = *p++ == '-';
+    if (p >= fim || *p < '0' || *p > '9')
+        return 0;
+
+    // Acumula em 64 bits; ao passar de UINT64_MAX fica saturado
+    uint64_t acumulado = 0;
+    while (fim - p >= 8)
+    {
+        uint64_t palavra;
+        memcpy(&palavra, p, 8);
+        int k = contarDigitos(palavra);
+        if (k == 8)
+        {
+            uint32_t bloco = converterOitoDigitos(palavra);
+            acumulado = acumulado > (UINT64_MAX - bloco) / 100000000ULL ? UINT64_MAX : acumulado * 100000000ULL + bloco;
+            p += 8;
+            continue;
+        }
+        // Alinha os k dígitos no fim da palavra e completa o início com '0'
+        if (k > 0)
+        {
+            uint64_t alinhado = (palavra << (8 * (8 - k))) | (0x3030303030303030ULL >> (8 * k));
+            uint64_t escala = 1;
+            for (int d = 0; d < k; d++)
+                escala *= 10;
+            uint32_t bloco = converterOitoDigitos(alinhado);
+            acumulado = acumulado > (UINT64_MAX - bloco) / escala ? UINT64_MAX : acumulado * escala + bloco;
+            p += k;
+        }
+        break;
+    }
+    // Fim do arquivo a menos de 8 bytes: dígito a dígito
+    if (fim - p < 8)
+        while (p < fim && *p >= '0' && *p <= '9')
+        {
+            uint64_t digito = (uint64_t)(*p++ - '0');
+            acumulado = acumulado > (UINT64_MAX - digito) / 10 ? UINT64_MAX : acumulado * 10 + digito;
+        }
+
+    e->pos = (size_t)(p - e->dados);
+    // Satura no alcance de long long (como strtol) e trunca para int
+    long long longo;
+    if (negativo)
+        longo = acumulado > (uint64_t)INT64_MAX ? INT64_MIN : -(long long)acumulado;
+    else
+        longo = acumulado > (uint64_t)INT64_MAX ? INT64_MAX : (long long)acumulado;
+    *valor = (int)longo;
+    return 1;
+}
 
-// Função para ler dados do arquivo
-SetArrays lerDados(FILE* arquivo)
+// Função para ler os arrays de uma entrada de texto
+SetArrays lerDadosTexto(Entrada *entrada)
 {
     // Inicializa resultado
-    SetArrays resultado = {NULL, 0};
+    SetArrays resultado = {NULL, 0, NULL, 0};
     int qtdArrays;
     // Lê a quantidade de arrays
-    if (fscanf(arquivo, "%d", &qtdArrays) != 1 || qtdArrays <= 0)
+    if (!lerInteiro(entrada, &qtdArrays) || qtdArrays <= 0)
         return resultado;
 
     // Aloca memória para os arrays
@@ -47,7 +278,7 @@ SetArrays lerDados(FILE* arquivo)
     for (int i = 0; i < qtdArrays; ++i)
     {
         // Lê o tamanho do array
-        if (fscanf(arquivo, "%d", &arrays[i].size) != 1 || arrays[i].size < 0)
+        if (!lerInteiro(entrada, &arrays[i].size) || arrays[i].size < 0)
         {
             arrays[i].array = NULL;
             continue;
@@ -71,7 +302,7 @@ SetArrays lerDados(FILE* arquivo)
 
         // Lê os elementos do array
         for (int j = 0; j < arrays[i].size; ++j)
-            if (fscanf(arquivo, "%d", &arrays[i].array[j]) != 1)
+            if (!lerInteiro(entrada, &arrays[i].array[j]))
                 arrays[i].array[j] = 0;
     }
 
@@ -81,169 +312,852 @@ SetArrays lerDados(FILE* arquivo)
     return resultado;
 }
 
-// Procedimento para trocar dois elementos com contagem
-void swap(int *a, int *b, Estatisticas *stats)
+// Função que valida o cabeçalho e as regiões de uma entrada binária antes de
+// confiar nos deslocamentos; devolve o cabeçalho ou NULL se o arquivo é inválido
+const CabecalhoBinario *validarBinario(const Entrada *entrada)
 {
-    // Incrementa o contador de trocas
-    stats->trocas++;
-    // Troca os valores
-    int temp = *a;
-    *a = *b;
-    *b = temp;
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    const CabecalhoBinario *cab = (const CabecalhoBinario *)entrada->dados;
+    const int32_t *tamanhos = (const int32_t *)(entrada->dados + sizeof(CabecalhoBinario));
+    int valido = cab->versao == VERSAO_BINARIO && cab->tamanho == entrada->tamanho && cab->qtdArrays > 0
+                 && cab->qtdArrays <= INT32_MAX && cab->offDados % 8 == 0
+                 && cab->offDados >= sizeof(CabecalhoBinario) + (uint64_t)cab->qtdArrays * sizeof(int32_t)
+                 && cab->offDados <= cab->tamanho;
+    uint64_t elementos = 0;
+    for (uint32_t i = 0; valido && i < cab->qtdArrays; i++)
+    {
+        valido = tamanhos[i] >= 0;
+        elementos += (uint64_t)(valido ? tamanhos[i] : 0);
+    }
+    if (valido && cab->tamanho - cab->offDados == elementos * sizeof(int32_t))
+        return cab;
+    fprintf(stderr, "Entrada binária inválida ou de versão incompatível.\n");
+#else
+    (void)entrada;
+    fprintf(stderr, "O formato binário exige uma máquina little-endian.\n");
+#endif
+    return NULL;
 }
 
-// Função que retorna o índice da mediana de três
-int mediana(int *array, int low, int high)
+// Função para usar uma entrada binária sem cópia: os arrays apontam para o mapa,
+// que passa a pertencer ao resultado; retorna qtdArrays 0 se o arquivo é inválido
+SetArrays lerDadosBinario(Entrada *entrada)
 {
-    // Calcula o tamanho do subarray
-    int n = high - low + 1;
-    // Calcula índices para mediana de três
-    int idx1 = low + (n/4);
-    int idx2 = low + (n/2);
-    int idx3 = low + (3*n/4);
-    // Obtém os valores dos três elementos
-    int a = array[idx1], b = array[idx2], c = array[idx3];
+    SetArrays resultado = {NULL, 0, NULL, 0};
+    const CabecalhoBinario *cab = validarBinario(entrada);
+    if (!cab)
+        return resultado;
 
-    // Compara para encontrar a mediana
-    if ((a <= b && b <= c) || (c <= b && b <= a))
-        return idx2;
-    else if ((b <= a && a <= c) || (c <= a && a <= b))
-        return idx1;
-    else
-        return idx3;
+    Array *arrays = malloc(sizeof(Array) * cab->qtdArrays);
+    if (!arrays)
+        return resultado;
+    const int32_t *tamanhos = (const int32_t *)(entrada->dados + sizeof(CabecalhoBinario));
+    int *dados = (int *)(entrada->dados + cab->offDados);
+    for (uint32_t i = 0; i < cab->qtdArrays; i++)
+    {
+        arrays[i].size = tamanhos[i];
+        arrays[i].array = tamanhos[i] > 0 ? dados : NULL;
+        dados += tamanhos[i];
+    }
+    resultado.arrays = arrays;
+    resultado.qtdArrays = (int)cab->qtdArrays;
+    // O mapa agora é do resultado
+    resultado.mapa = (void *)entrada->dados;
+    resultado.tamanhoMapa = entrada->tamanho;
+    entrada->dados = NULL;
+    entrada->tamanho = 0;
+    return resultado;
 }
 
-// Função QuickSort Lomuto Padrão
-int lomutoPadrao(int *array, int low, int high, Estatisticas *stats)
+// Função para ler dados do arquivo (texto ou binário, detectado pela assinatura)
+SetArrays lerDados(Entrada *entrada)
 {
-    // Usa o último elemento como pivô
-    int pivo = array[high];
-    // Índice do menor elemento
-    int i = low - 1;
+    return entradaBinaria(entrada) ? lerDadosBinario(entrada) : lerDadosTexto(entrada);
+}
 
-    // Percorre todos os elementos
-    for (int j = low; j < high; j++)
-        // Verifica se o elemento atual é menor ou igual ao pivô
-        if (array[j] <= pivo)
-        {
-            // Incrementa o índice do menor elemento
-            i++;
-            // Troca array[i] e array[j]
-            swap(&array[i], &array[j], stats);
-        }
+// Função para gravar os arrays no formato binário; retorna 0 em caso de erro
+int escreverBinario(FILE *arquivo, SetArrays *set)
+{
+    static const char zeros[8] = {0};
+    CabecalhoBinario cab;
+    memset(&cab, 0, sizeof(cab));
+    memcpy(cab.magica, MAGICA_BINARIO, 8);
+    cab.versao = VERSAO_BINARIO;
+    cab.qtdArrays = (uint32_t)set->qtdArrays;
+    cab.offDados = alinhar8(sizeof(CabecalhoBinario) + (uint64_t)set->qtdArrays * sizeof(int32_t));
+    uint64_t elementos = 0;
+    for (int i = 0; i < set->qtdArrays; i++)
+        if (set->arrays[i].size > 0)
+            elementos += (uint64_t)set->arrays[i].size;
+    cab.tamanho = cab.offDados + elementos * sizeof(int32_t);
 
-    // Coloca o pivô na posição correta
-    swap(&array[i + 1], &array[high], stats);
-    
-    return i + 1; // Retorna o índice do pivô
+    // Cabeçalho, tamanhos (inválidos viram 0), alinhamento e elementos
+    fwrite(&cab, sizeof(cab), 1, arquivo);
+    for (int i = 0; i < set->qtdArrays; i++)
+    {
+        int32_t tamanho = set->arrays[i].size > 0 ? set->arrays[i].size : 0;
+        fwrite(&tamanho, sizeof(tamanho), 1, arquivo);
+    }
+    fwrite(zeros, 1, (size_t)(cab.offDados - sizeof(cab) - (uint64_t)set->qtdArrays * sizeof(int32_t)), arquivo);
+    for (int i = 0; i < set->qtdArrays; i++)
+        if (set->arrays[i].size > 0)
+            fwrite(set->arrays[i].array, sizeof(int32_t), (size_t)set->arrays[i].size, arquivo);
+    return !ferror(arquivo);
 }
 
-// Função para Lomuto com mediana de três
-int lomutoMediana(int *array, int low, int high, Estatisticas *stats)
+// Função para gravar os arrays no formato de texto da entrada; retorna 0 em caso de erro
+int escreverTexto(FILE *arquivo, SetArrays *set)
 {
-    // Seleciona o pivô como a mediana de três
-    int pivoIdx = mediana(array, low, high);
-    // Move o pivô para o final
-    swap(&array[high], &array[pivoIdx], stats);
-    
-    return lomutoPadrao(array, low, high, stats);
+    fprintf(arquivo, "%d\n", set->qtdArrays);
+    for (int i = 0; i < set->qtdArrays; i++)
+    {
+        int tamanho = set->arrays[i].size > 0 ? set->arrays[i].size : 0;
+        fprintf(arquivo, "%d\n", tamanho);
+        for (int j = 0; j < tamanho; j++)
+            fprintf(arquivo, j + 1 < tamanho ? "%d " : "%d", set->arrays[i].array[j]);
+        fprintf(arquivo, "\n");
+    }
+    return !ferror(arquivo);
 }
 
-// Função para Lomuto com pivô aleatório
-int lomutoRandom(int *array, int low, int high, Estatisticas *stats)
+// Compara pela ordem natural (inteiros)
+#define MENOR_NATURAL(a, b) ((a) < (b))
+// Ordem total dos reais: a natural, com os NaN depois de todos os números (com "<" puro
+// um NaN não é menor nem maior que nada e as partições param antes da hora)
+#define MENOR_REAL(a, b) (!isnan(a) && (isnan(b) || (a) < (b)))
+// Semente do pivô "aleatório": valor absoluto (sem estouro em INT_MIN)
+#define SEMENTE_INT(x) ((unsigned long long)((x) < 0 ? -(long long)(x) : (long long)(x)))
+#define SEMENTE_INT64(x) ((x) < 0 ? -(unsigned long long)(x) : (unsigned long long)(x))
+#define SEMENTE_UINT64(x) ((unsigned long long)(x))
+#define SEMENTE_REAL(x) sementeReal(x)
+#define SEMENTE_REGISTRO(x) ((unsigned long long)(x).chave)
+
+// Registro ordenado pela chave (ex.: timestamp) carregando um valor associado
+typedef struct
+{
+    uint64_t chave;
+    uint64_t carga;
+} RegistroChaveCarga;
+
+// Compara registros só pela chave
+#define MENOR_REGISTRO(a, b) ((a).chave < (b).chave)
+
+// Função que deriva a semente do pivô de um real: os bits do seu valor absoluto
+static inline unsigned long long sementeReal(double x)
 {
-    // Escolhe um pivô aleatório e o move para o final
-    swap(&array[high], &array[low + abs(array[low]) % (high - low + 1)], stats);
-    
-    return lomutoPadrao(array, low, high, stats);
+    unsigned long long bits;
+    x = fabs(x);
+    memcpy(&bits, &x, sizeof(bits));
+    return bits;
 }
 
-// Função para Hoare Padrão
-int hoarePadrao(int *array, int low, int high, Estatisticas *stats)
-{
-    // Escolhe o primeiro elemento como pivô
-    int pivo = array[low];
-    // Escolhe o índice inicial e final
-    int i = low - 1;
-    int j = high + 1;
+// Métodos LP a DP e o híbrido PD especializados para cada tipo de chave
+DEFINIR_QUICKSORT(quickSortInt, int, MENOR_NATURAL, SEMENTE_INT)
+DEFINIR_QUICKSORT(quickSortInt64, int64_t, MENOR_NATURAL, SEMENTE_INT64)
+DEFINIR_QUICKSORT(quickSortUint64, uint64_t, MENOR_NATURAL, SEMENTE_UINT64)
+DEFINIR_QUICKSORT(quickSortFloat, float, MENOR_REAL, SEMENTE_REAL)
+DEFINIR_QUICKSORT(quickSortDouble, double, MENOR_REAL, SEMENTE_REAL)
+DEFINIR_QUICKSORT(quickSortRegistro, RegistroChaveCarga, MENOR_REGISTRO, SEMENTE_REGISTRO)
 
-    // Loop infinito até os índices se cruzarem
+// Kernel de partição por valor: reorganiza [ini, fim) em menores | demais, onde
+// "menor" é x < pivô (ou x <= pivô com inclusivo), e devolve o ponto de corte.
+// O arranjo de cada lado depende do kernel. Contabilidade de trocas: o escalar conta
+// cada par trocado; os vetoriais gravam as próprias chaves e contam uma troca por par
+// de chaves fora de lugar, o mínimo entre os "demais" lidos da região esquerda e os
+// menores lidos da direita, com as regiões separadas onde as leituras das duas pontas
+// se encontram. Quando esse encontro cai no corte é exatamente a contagem do escalar;
+// fora dele o número muda, e como os vetoriais também desfazem sequências já ordenadas,
+// o custo do VM varia entre kernels, mais em entradas quase ordenadas
+typedef int (*KernelParticao)(int *array, int ini, int fim, int pivo, int inclusivo, Estatisticas *stats);
+
+// Kernel escalar (referência e fallback): partição de dois ponteiros
+int particaoValorEscalar(int *array, int ini, int fim, int pivo, int inclusivo, Estatisticas *stats)
+{
+    int i = ini, j = fim - 1;
     while (1)
     {
-        // Encontra o elemento à esquerda que deve estar à direita
-        do {
+        while (i <= j && COMPARAR(inclusivo ? array[i] <= pivo : array[i] < pivo, stats))
             i++;
-        } while (array[i] < pivo);
-
-        // Encontra o elemento à direita que deve estar à esquerda
-        do {
+        while (i <= j && !COMPARAR(inclusivo ? array[j] <= pivo : array[j] < pivo, stats))
             j--;
-        } while (array[j] > pivo);
+        // i == j é impossível aqui: o elemento seria menor e não menor ao mesmo tempo
+        if (i > j)
+            return i;
+        quickSortIntTrocar(&array[i], &array[j], stats);
+        i++;
+        j--;
+    }
+}
+
+#ifdef TEM_X86
+// Os kernels vetoriais precisam de ao menos dois vetores (as duas pontas salvas);
+// abaixo disso usam o escalar
+
+// Função que termina a partição vetorial: as chaves que sobraram (o resto não lido e
+// os vetores salvos das pontas, as qtdEsquerda primeiras vindas da região esquerda)
+// são escritas uma a uma na lacuna [escEsq, escEsq + qtd), que neste ponto é contígua.
+// Soma as fora de lugar de cada região e devolve o ponto de corte. Sem desvios: como
+// toda a lacuna está livre, cada chave é gravada nas duas pontas e só uma avança
+static int finalizarParticaoVetorial(int *array, const int *valores, int qtd, int qtdEsquerda, int pivo,
+                                     int inclusivo, int escEsq, long long *foraEsq, long long *foraDir)
+{
+    int escDir = escEsq + qtd;
+    for (int k = 0; k < qtd; k++)
+    {
+        int menor = inclusivo ? valores[k] <= pivo : valores[k] < pivo;
+        if (k < qtdEsquerda) *foraEsq += !menor;
+        else *foraDir += menor;
+        array[escEsq] = valores[k];
+        array[escDir - 1] = valores[k];
+        escEsq += menor;
+        escDir -= !menor;
+    }
+    return escEsq;
+}
+
+// Kernel AVX-512: compara 16 chaves por vez e grava as menores no fim da região
+// esquerda e as demais no início da direita, compactadas por compress. Sem memória
+// extra: os vetores das pontas são salvos em registradores, abrindo 32 posições
+// livres, e sempre se lê do lado com menos espaço livre; assim cada lado tem ao
+// menos 16 posições já lidas para gravar. A gravação da esquerda é um vetor inteiro
+// (as raias além das menores caem na lacuna e são sobrescritas depois) e a da
+// direita é mascarada, para não passar das demais já gravadas
+__attribute__((target("avx512f,popcnt")))
+int particaoValorAvx512(int *array, int ini, int fim, int pivo, int inclusivo, Estatisticas *stats)
+{
+    if (fim - ini < 2 * 16)
+        return particaoValorEscalar(array, ini, fim, pivo, inclusivo, stats);
+    __m512i vpivo = _mm512_set1_epi32(pivo);
+
+    // Máscara das raias menores (x < pivô, ou x <= pivô com inclusivo)
+    #define MASCARA_AVX512(v) (inclusivo ? _mm512_cmple_epi32_mask((v), vpivo) : _mm512_cmplt_epi32_mask((v), vpivo))
+
+    // Salva os vetores das pontas, abrindo 16 posições livres em cada lado
+    __m512i salvoEsq = _mm512_loadu_si512(array + ini);
+    __m512i salvoDir = _mm512_loadu_si512(array + fim - 16);
+    int lerEsq = ini + 16, lerDir = fim - 16, escEsq = ini, escDir = fim;
+    long long foraEsq = 0, foraDir = 0;
+
+    while (lerDir - lerEsq >= 16)
+    {
+        // Lê do lado com menos espaço livre, somando as chaves fora de lugar da região
+        __m512i v;
+        __mmask16 m;
+        if (lerEsq - escEsq <= escDir - lerDir)
+        {
+            v = _mm512_loadu_si512(array + lerEsq);
+            lerEsq += 16;
+            m = MASCARA_AVX512(v);
+            foraEsq += 16 - __builtin_popcount(m);
+        } else
+        {
+            lerDir -= 16;
+            v = _mm512_loadu_si512(array + lerDir);
+            m = MASCARA_AVX512(v);
+            foraDir += __builtin_popcount(m);
+        }
+        int k = __builtin_popcount(m);
+
+        // Menores no fim da região esquerda, demais no início da região direita
+        _mm512_storeu_si512(array + escEsq, _mm512_maskz_compress_epi32(m, v));
+        _mm512_mask_storeu_epi32(array + escDir - (16 - k), (__mmask16)((1u << (16 - k)) - 1),
+                                 _mm512_maskz_compress_epi32((__mmask16)~m, v));
+        escEsq += k;
+        escDir -= 16 - k;
+    }
+    #undef MASCARA_AVX512
+
+    // Resto não lido e vetor salvo da esquerda (região esquerda), depois o da direita
+    int valores[3 * 16], qtd = 0;
+    for (int p = lerEsq; p < lerDir; p++)
+        valores[qtd++] = array[p];
+    _mm512_storeu_si512(valores + qtd, salvoEsq);
+    _mm512_storeu_si512(valores + qtd + 16, salvoDir);
+    int corte = finalizarParticaoVetorial(array, valores, qtd + 32, qtd + 16, pivo, inclusivo, escEsq, &foraEsq, &foraDir);
+
+    // Uma comparação por chave e uma troca por par fora de lugar
+    stats->comparacoes += fim - ini;
+    stats->trocas += foraEsq < foraDir ? foraEsq : foraDir;
+    return corte;
+}
+
+// Tabela de permutação do AVX2: para cada máscara de 8 raias, os índices das raias
+// menores (em ordem) seguidos dos das demais
+static int tabelaPermutacao[256][8];
+
+// Procedimento que preenche a tabela de permutação
+void iniciarTabelaPermutacao(void)
+{
+    for (int m = 0; m < 256; m++)
+    {
+        int k = 0;
+        for (int r = 0; r < 8; r++)
+            if (m & (1 << r)) tabelaPermutacao[m][k++] = r;
+        for (int r = 0; r < 8; r++)
+            if (!(m & (1 << r))) tabelaPermutacao[m][k++] = r;
+    }
+}
 
-        // Se os índices se cruzarem, a partição está concluída
-        if (i >= j)
-            return j;
+// Kernel AVX2: mesma estratégia do AVX-512 com 8 raias; sem compress, o vetor é
+// permutado pela tabela (menores na frente, demais no fim) e gravado inteiro nos
+// dois lados, avançando cada ponteiro só pelas raias válidas
+__attribute__((target("avx2,popcnt")))
+int particaoValorAvx2(int *array, int ini, int fim, int pivo, int inclusivo, Estatisticas *stats)
+{
+    if (fim - ini < 2 * 8)
+        return particaoValorEscalar(array, ini, fim, pivo, inclusivo, stats);
+    __m256i vpivo = _mm256_set1_epi32(pivo);
+
+    // Máscara das raias menores: pivô > x, ou com inclusivo, não (x > pivô)
+    #define MASCARA_AVX2(v) (inclusivo \
+        ? (~_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32((v), vpivo))) & 0xFF) \
+        : _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(vpivo, (v)))))
+
+    // Salva os vetores das pontas, abrindo 8 posições livres em cada lado
+    __m256i salvoEsq = _mm256_loadu_si256((const __m256i *)(array + ini));
+    __m256i salvoDir = _mm256_loadu_si256((const __m256i *)(array + fim - 8));
+    int lerEsq = ini + 8, lerDir = fim - 8, escEsq = ini, escDir = fim;
+    long long foraEsq = 0, foraDir = 0;
+
+    while (lerDir - lerEsq >= 8)
+    {
+        // Lê do lado com menos espaço livre (cada lado fica com ao menos 8 livres)
+        __m256i v;
+        int m;
+        if (lerEsq - escEsq <= escDir - lerDir)
+        {
+            v = _mm256_loadu_si256((const __m256i *)(array + lerEsq));
+            lerEsq += 8;
+            m = MASCARA_AVX2(v);
+            foraEsq += 8 - __builtin_popcount(m);
+        } else
+        {
+            lerDir -= 8;
+            v = _mm256_loadu_si256((const __m256i *)(array + lerDir));
+            m = MASCARA_AVX2(v);
+            foraDir += __builtin_popcount(m);
+        }
+        int k = __builtin_popcount(m);
+
+        // Menores na frente, demais no fim; grava o vetor inteiro nos dois lados
+        __m256i permutado = _mm256_permutevar8x32_epi32(v, _mm256_loadu_si256((const __m256i *)tabelaPermutacao[m]));
+        _mm256_storeu_si256((__m256i *)(array + escEsq), permutado);
+        _mm256_storeu_si256((__m256i *)(array + escDir - 8), permutado);
+        escEsq += k;
+        escDir -= 8 - k;
+    }
+    #undef MASCARA_AVX2
+
+    // Resto não lido e vetor salvo da esquerda (região esquerda), depois o da direita
+    int valores[3 * 8], qtd = 0;
+    for (int p = lerEsq; p < lerDir; p++)
+        valores[qtd++] = array[p];
+    _mm256_storeu_si256((__m256i *)(valores + qtd), salvoEsq);
+    _mm256_storeu_si256((__m256i *)(valores + qtd + 8), salvoDir);
+    int corte = finalizarParticaoVetorial(array, valores, qtd + 16, qtd + 8, pivo, inclusivo, escEsq, &foraEsq, &foraDir);
 
-        // Troca os elementos fora de ordem
-        swap(&array[i], &array[j], stats);
+    stats->comparacoes += fim - ini;
+    stats->trocas += foraEsq < foraDir ? foraEsq : foraDir;
+    return corte;
+}
+#endif
+
+// Kernel em uso pelo método VM (escolhido uma vez, antes das threads)
+static KernelParticao kernelParticao = particaoValorEscalar;
+
+// Função que escolhe o kernel: "avx512", "avx2", "escalar" ou NULL para detectar
+// pelo CPUID; devolve 0 se o kernel pedido não é suportado pelo processador
+int selecionarKernel(const char *nome)
+{
+    kernelParticao = particaoValorEscalar;
+    if (nome && strcmp(nome, "escalar") == 0)
+        return 1;
+#ifdef TEM_X86
+    __builtin_cpu_init();
+    int avx512 = __builtin_cpu_supports("avx512f");
+    int avx2 = __builtin_cpu_supports("avx2");
+    if (nome && strcmp(nome, "avx512") == 0)
+    {
+        if (!avx512) return 0;
+        kernelParticao = particaoValorAvx512;
+    }
+    else if (nome && strcmp(nome, "avx2") == 0)
+    {
+        if (!avx2) return 0;
+        kernelParticao = particaoValorAvx2;
     }
+    else if (avx512) kernelParticao = particaoValorAvx512;
+    else if (avx2) kernelParticao = particaoValorAvx2;
+    if (kernelParticao == particaoValorAvx2)
+        iniciarTabelaPermutacao();
+    return 1;
+#else
+    return nome == NULL;
+#endif
+}
+
+// Procedimento de partição vetorial com pivô mediana de três: o pivô vai para o fim,
+// o kernel separa < pivô | >= pivô e o pivô é colocado no corte. Se o pivô é o mínimo
+// da faixa, um segundo passo separa as chaves iguais a ele, que não são revisitadas
+void vetorialMediana(int *array, int low, int high, Subfaixas *sub, Estatisticas *stats)
+{
+    // Seleciona o pivô como a mediana de três e o move para o final
+    quickSortIntTrocar(&array[high], &array[quickSortIntMediana(array, low, high, stats)], stats);
+    int pivo = array[high];
+
+    int corte = kernelParticao(array, low, high, pivo, 0, stats);
+    quickSortIntTrocar(&array[corte], &array[high], stats);
+    sub->ini[0] = low;
+    sub->fim[0] = corte - 1;
+    sub->ini[1] = corte + 1;
+    sub->fim[1] = high;
+    sub->qtd = 2;
+
+    // Nenhum menor que o pivô: [low + 1, high] >= pivô, separa os iguais
+    if (corte == low && low < high)
+        sub->ini[1] = kernelParticao(array, low + 1, high + 1, pivo, 1, stats);
 }
 
-// Função para Hoare com pivô mediana de três
-int hoareMediana(int *array, int low, int high, Estatisticas *stats)
+// Método VM: o mesmo laço dos demais sobre o passo vetorial
+DEFINIR_QUICKSORT_DRIVER(quickSortIntVM, int, vetorialMediana)
+
+// Ordenadores de cada método (índice = código - 1); cada um já tem esquema e
+// pivô fixados, então a escolha do método acontece uma vez por ordenação
+static void (*const ordenadoresInt[QTD_METODOS])(int *, int, int, Estatisticas *) = {
+    quickSortIntLP, quickSortIntLM, quickSortIntLA, quickSortIntHP, quickSortIntHM, quickSortIntHA,
+    quickSortIntBM, quickSortIntBA, quickSortIntTV, quickSortIntDP, quickSortIntVM, quickSortIntPD,
+    quickSortIntLR, quickSortIntLN, quickSortIntLS, quickSortIntLD, quickSortIntHR, quickSortIntHN,
+    quickSortIntHS, quickSortIntHD, quickSortIntBR, quickSortIntBN, quickSortIntBS, quickSortIntBD,
+    quickSortIntTR, quickSortIntTN, quickSortIntTS, quickSortIntTD, quickSortIntDR, quickSortIntDN,
+    quickSortIntDS, quickSortIntDD
+};
+
+// Passos de partição de cada método; o híbrido (PD) não tem passo isolado
+static void (*const passosInt[QTD_METODOS])(int *, int, int, Subfaixas *, Estatisticas *) = {
+    quickSortIntLPPasso, quickSortIntLMPasso, quickSortIntLAPasso, quickSortIntHPPasso,
+    quickSortIntHMPasso, quickSortIntHAPasso, quickSortIntBMPasso, quickSortIntBAPasso,
+    quickSortIntTVPasso, quickSortIntDPPasso, vetorialMediana, NULL,
+    quickSortIntLRPasso, quickSortIntLNPasso, quickSortIntLSPasso, quickSortIntLDPasso,
+    quickSortIntHRPasso, quickSortIntHNPasso, quickSortIntHSPasso, quickSortIntHDPasso,
+    quickSortIntBRPasso, quickSortIntBNPasso, quickSortIntBSPasso, quickSortIntBDPasso,
+    quickSortIntTRPasso, quickSortIntTNPasso, quickSortIntTSPasso, quickSortIntTDPasso,
+    quickSortIntDRPasso, quickSortIntDNPasso, quickSortIntDSPasso, quickSortIntDDPasso
+};
+
+// Semente do gerador dos pivôs aleatórios (R), reaplicada a cada ordenação
+static uint64_t sementePivos = 42;
+
+// Função que faz um passo de partição do método na faixa [low, high] (low < high)
+// e devolve as subfaixas restantes; devolve 0 para método sem passo de partição
+int particionarFaixa(int *array, int low, int high, int method, Subfaixas *sub, Estatisticas *stats)
 {
-    // Seleciona o pivô como a mediana de três
-    int pivoIdx = mediana(array, low, high);
-    // Move o pivô para o início
-    swap(&array[low], &array[pivoIdx], stats);
-    
-    return hoarePadrao(array, low, high, stats);
+    if (passosInt[method - 1] == NULL)
+        return 0;
+    passosInt[method - 1](array, low, high, sub, stats);
+    return 1;
 }
 
-// Função para Hoare com pivô aleatório
-int hoareRandom(int *array, int low, int high, Estatisticas *stats)
+// Procedimento que ordena a faixa [low, high] com o método, sem contar a chamada
+// da própria faixa (contada por quem a criou)
+void ordenarFaixa(int *array, int low, int high, int method, Estatisticas *stats)
 {
-    // Escolhe um pivô aleatório e o move para o início
-    swap(&array[low], &array[low + abs(array[low]) % (high - low + 1)], stats);
-    
-    return hoarePadrao(array, low, high, stats);
+    ordenadoresInt[method - 1](array, low, high, stats);
 }
 
-// Procedimento Quick Sort
+// Procedimento Quick Sort (iterativo, com pilha explícita)
 void quickSort(int *array, int low, int high, int method, Estatisticas *stats)
 {
-    // Incrementa o contador de chamadas
+    // Incrementa o contador de chamadas da chamada inicial
     stats->chamadas++;
-    
-    // Verifica se o subarray tem mais de um elemento
-    if(low < high)
+    // Pivôs aleatórios reprodutíveis: mesma sequência em toda ordenação
+    semearPivoAleatorio(sementePivos);
+    ordenarFaixa(array, low, high, method, stats);
+}
+
+// Faixas acima deste tamanho viram tarefas no modo paralelo
+#define LIMIAR_TAREFA (1 << 13)
+// Faixas acima deste tamanho são divididas pela partição paralela (todas as threads)
+#define LIMIAR_PARTICAO_PARALELA (1 << 20)
+// Capacidade do deque de tarefas de cada thread
+#define CAPACIDADE_DEQUE 1024
+
+// Deque de tarefas de uma thread: a dona empilha e retira no fim (LIFO, faixas
+// recentes ainda no cache) e as outras roubam do início (as faixas mais antigas,
+// que são as maiores)
+typedef struct
+{
+    int faixas[CAPACIDADE_DEQUE][2];
+    // Itens em [inicio, fim), posição real = índice % CAPACIDADE_DEQUE
+    long inicio, fim;
+    pthread_mutex_t trava;
+} DequeTarefas;
+
+// Estado compartilhado da ordenação paralela de um array
+typedef struct
+{
+    int *array;
+    int method;
+    int threads;
+    pthread_barrier_t barreira;
+    // Largada: as auxiliares só começam depois de todas as criações tentadas, para
+    // que threads e barreira contem apenas as threads que existem
+    pthread_mutex_t travaLargada;
+    pthread_cond_t sinalLargada;
+    int largada;
+    // Estatísticas por thread, somadas no fim
+    Estatisticas *stats;
+    DequeTarefas *deques;
+    // Tarefas criadas e ainda não concluídas
+    long pendentes;
+
+    // Fase 1 (partição paralela): faixas iniciais, faixa em divisão e seu pivô
+    int (*faixasIniciais)[2];
+    int qtdFaixas;
+    int faixaAtual;
+    int pivo;
+    int parar;
+    // Buffer auxiliar da partição paralela e contagens por thread
+    int *auxiliar;
+    int *menores;
+    int *baseMenor;
+    int *baseMaior;
+    int corte;
+} OrdenacaoParalela;
+
+// Função que empilha uma faixa no deque; devolve 0 se o deque está cheio
+int empilharTarefa(DequeTarefas *d, int low, int high)
+{
+    pthread_mutex_lock(&d->trava);
+    int ok = d->fim - d->inicio < CAPACIDADE_DEQUE;
+    if (ok)
+    {
+        d->faixas[d->fim % CAPACIDADE_DEQUE][0] = low;
+        d->faixas[d->fim % CAPACIDADE_DEQUE][1] = high;
+        d->fim++;
+    }
+    pthread_mutex_unlock(&d->trava);
+    return ok;
+}
+
+// Função que retira uma faixa do deque: do fim (dona) ou do início (roubo)
+int retirarTarefa(DequeTarefas *d, int roubo, int *faixa)
+{
+    pthread_mutex_lock(&d->trava);
+    int ok = d->fim > d->inicio;
+    if (ok)
+    {
+        long k = roubo ? d->inicio++ : --d->fim;
+        faixa[0] = d->faixas[k % CAPACIDADE_DEQUE][0];
+        faixa[1] = d->faixas[k % CAPACIDADE_DEQUE][1];
+    }
+    pthread_mutex_unlock(&d->trava);
+    return ok;
+}
+
+// Procedimento que semeia o gerador dos pivôs R a partir da semente e da faixa, de modo
+// que os pivôs de cada faixa não dependam da thread que a processa nem da ordem dos roubos
+void semearPivoFaixa(int low, int high)
+{
+    // Mistura final do splitmix64 sobre a semente e os dois limites
+    uint64_t x = sementePivos * 0x9E3779B97F4A7C15ULL + (((uint64_t)(uint32_t)low << 32) | (uint32_t)high);
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    semearPivoAleatorio(x ^ (x >> 31));
+}
+
+// Procedimento que processa uma tarefa: enquanto a faixa é grande, faz um passo de
+// partição do próprio método, publica as subfaixas grandes para roubo e segue numa
+// delas; o resto é ordenado em série. Cada faixa semeia os pivôs R por semearPivoFaixa,
+// então as contagens não dependem do escalonamento; fora os pivôs R, são as mesmas
+// da versão serial
+void processarTarefa(OrdenacaoParalela *ord, int id, int low, int high)
+{
+    Estatisticas *stats = &ord->stats[id];
+    // O método híbrido não tem passo de partição separado: ordena a faixa inteira
+    while (ord->method != 12 && high - low + 1 > LIMIAR_TAREFA)
+    {
+        Subfaixas sub;
+        semearPivoFaixa(low, high);
+        if (!particionarFaixa(ord->array, low, high, ord->method, &sub, stats))
+            return;
+        stats->chamadas += sub.qtd;
+
+        // Segue na maior subfaixa; as outras grandes viram tarefas, as pequenas são feitas já
+        int maior = 0;
+        for (int f = 1; f < sub.qtd; f++)
+            if (sub.fim[f] - sub.ini[f] > sub.fim[maior] - sub.ini[maior])
+                maior = f;
+        for (int f = 0; f < sub.qtd; f++)
+        {
+            if (f == maior)
+                continue;
+            if (sub.fim[f] - sub.ini[f] + 1 > LIMIAR_TAREFA)
+            {
+                __atomic_add_fetch(&ord->pendentes, 1, __ATOMIC_SEQ_CST);
+                if (empilharTarefa(&ord->deques[id], sub.ini[f], sub.fim[f]))
+                    continue;
+                // Deque cheio: a própria thread faz a faixa, como se a tivesse roubado
+                __atomic_sub_fetch(&ord->pendentes, 1, __ATOMIC_SEQ_CST);
+                processarTarefa(ord, id, sub.ini[f], sub.fim[f]);
+                continue;
+            }
+            semearPivoFaixa(sub.ini[f], sub.fim[f]);
+            ordenarFaixa(ord->array, sub.ini[f], sub.fim[f], ord->method, stats);
+        }
+        low = sub.ini[maior];
+        high = sub.fim[maior];
+    }
+    semearPivoFaixa(low, high);
+    ordenarFaixa(ord->array, low, high, ord->method, stats);
+}
+
+// Procedimento de um passo da partição paralela, executado por todas as threads
+// sobre a faixa atual [lo, hi] com o pivô já em array[hi]: cada thread conta os
+// menores do seu pedaço, a thread 0 calcula os deslocamentos, e cada thread copia
+// seus elementos para o buffer auxiliar (< pivô | >= pivô), que volta para o array.
+// Trocas contadas como na partição de dois ponteiros: um par fora de lugar conta uma troca
+void passoParticaoParalela(OrdenacaoParalela *ord, int id)
+{
+    int lo = ord->faixasIniciais[ord->faixaAtual][0];
+    int hi = ord->faixasIniciais[ord->faixaAtual][1];
+    long m = hi - lo;
+    int ini = lo + (int)(m * id / ord->threads);
+    int fim = lo + (int)(m * (id + 1) / ord->threads);
+    int pivo = ord->pivo;
+    int *array = ord->array;
+    Estatisticas *stats = &ord->stats[id];
+
+    // Conta os menores do pedaço
+    int menores = 0;
+    for (int i = ini; i < fim; i++)
+        menores += array[i] < pivo;
+    ord->menores[id] = menores;
+    stats->comparacoes += fim - ini;
+    pthread_barrier_wait(&ord->barreira);
+
+    // Deslocamentos de cada thread nas duas regiões
+    if (id == 0)
+    {
+        int total = 0;
+        for (int t = 0; t < ord->threads; t++)
+            total += ord->menores[t];
+        ord->corte = lo + total;
+        int baseMenor = lo, baseMaior = ord->corte;
+        for (int t = 0; t < ord->threads; t++)
+        {
+            int tIni = lo + (int)(m * t / ord->threads), tFim = lo + (int)(m * (t + 1) / ord->threads);
+            ord->baseMenor[t] = baseMenor;
+            ord->baseMaior[t] = baseMaior;
+            baseMenor += ord->menores[t];
+            baseMaior += (tFim - tIni) - ord->menores[t];
+        }
+    }
+    pthread_barrier_wait(&ord->barreira);
+
+    // Distribui o pedaço no buffer auxiliar
+    int posMenor = ord->baseMenor[id], posMaior = ord->baseMaior[id], corte = ord->corte;
+    long long foraDeLugar = 0;
+    for (int i = ini; i < fim; i++)
+    {
+        if (array[i] < pivo)
+            ord->auxiliar[posMenor++] = array[i];
+        else
+        {
+            foraDeLugar += i < corte;
+            ord->auxiliar[posMaior++] = array[i];
+        }
+    }
+    stats->comparacoes += fim - ini;
+    stats->trocas += foraDeLugar;
+    pthread_barrier_wait(&ord->barreira);
+
+    // Copia de volta o mesmo pedaço
+    memcpy(array + ini, ord->auxiliar + ini, sizeof(int) * (fim - ini));
+}
+
+// Argumento de cada thread da ordenação paralela
+typedef struct
+{
+    OrdenacaoParalela *ord;
+    int id;
+} TarefaOrdenacao;
+
+// Trabalhador da ordenação paralela: fase 1 divide as faixas grandes com a partição
+// paralela (todas as threads juntas), fase 2 processa tarefas com roubo de trabalho
+void *ordenacaoTrabalhador(void *arg)
+{
+    TarefaOrdenacao *tarefa = arg;
+    OrdenacaoParalela *ord = tarefa->ord;
+    int id = tarefa->id;
+    pthread_mutex_lock(&ord->travaLargada);
+    while (!ord->largada)
+        pthread_cond_wait(&ord->sinalLargada, &ord->travaLargada);
+    pthread_mutex_unlock(&ord->travaLargada);
+
+    // Fase 1: a thread 0 escolhe a maior faixa e todas a particionam juntas, até
+    // haver duas faixas por thread ou nenhuma acima do limiar
+    while (1)
+    {
+        if (id == 0)
+        {
+            int maior = 0;
+            for (int f = 1; f < ord->qtdFaixas; f++)
+                if (ord->faixasIniciais[f][1] - ord->faixasIniciais[f][0] > ord->faixasIniciais[maior][1] - ord->faixasIniciais[maior][0])
+                    maior = f;
+            int lo = ord->faixasIniciais[maior][0], hi = ord->faixasIniciais[maior][1];
+            ord->parar = ord->qtdFaixas >= 2 * ord->threads || hi - lo + 1 <= LIMIAR_PARTICAO_PARALELA;
+            if (!ord->parar)
+            {
+                // Pivô mediana de três, movido para o fim da faixa
+                ord->faixaAtual = maior;
+                quickSortIntTrocar(&ord->array[hi], &ord->array[quickSortIntMediana(ord->array, lo, hi, &ord->stats[0])], &ord->stats[0]);
+                ord->pivo = ord->array[hi];
+            }
+        }
+        pthread_barrier_wait(&ord->barreira);
+        if (ord->parar)
+            break;
+
+        passoParticaoParalela(ord, id);
+        pthread_barrier_wait(&ord->barreira);
+
+        // Coloca o pivô no corte e troca a faixa pelas duas metades
+        if (id == 0)
+        {
+            int f = ord->faixaAtual;
+            int hi = ord->faixasIniciais[f][1];
+            quickSortIntTrocar(&ord->array[ord->corte], &ord->array[hi], &ord->stats[0]);
+            ord->stats[0].chamadas += 2;
+            ord->faixasIniciais[f][1] = ord->corte - 1;
+            ord->faixasIniciais[ord->qtdFaixas][0] = ord->corte + 1;
+            ord->faixasIniciais[ord->qtdFaixas][1] = hi;
+            ord->qtdFaixas++;
+        }
+    }
+
+    // Distribui as faixas iniciais entre os deques (alternando as threads)
+    for (int f = id; f < ord->qtdFaixas; f += ord->threads)
+        if (ord->faixasIniciais[f][0] < ord->faixasIniciais[f][1])
+        {
+            __atomic_add_fetch(&ord->pendentes, 1, __ATOMIC_SEQ_CST);
+            if (!empilharTarefa(&ord->deques[id], ord->faixasIniciais[f][0], ord->faixasIniciais[f][1]))
+            {
+                __atomic_sub_fetch(&ord->pendentes, 1, __ATOMIC_SEQ_CST);
+                processarTarefa(ord, id, ord->faixasIniciais[f][0], ord->faixasIniciais[f][1]);
+            }
+        }
+    pthread_barrier_wait(&ord->barreira);
+
+    // Fase 2: tarefas do próprio deque; sem elas, rouba das outras threads
+    while (1)
     {
-        // Índice do pivô após partição
-        int mid;
+        int faixa[2];
+        int achou = retirarTarefa(&ord->deques[id], 0, faixa);
+        for (int v = 1; !achou && v < ord->threads; v++)
+            achou = retirarTarefa(&ord->deques[(id + v) % ord->threads], 1, faixa);
 
-        // Seleciona o método de partição com base no parâmetro
-        switch(method)
+        if (achou)
         {
-            case 1: mid = lomutoPadrao(array, low, high, stats); break;
-            case 2: mid = lomutoMediana(array, low, high, stats); break;
-            case 3: mid = lomutoRandom(array, low, high, stats); break;
-            case 4: mid = hoarePadrao(array, low, high, stats); break;
-            case 5: mid = hoareMediana(array, low, high, stats); break;
-            case 6: mid = hoareRandom(array, low, high, stats); break;
-            default: break;
+            processarTarefa(ord, id, faixa[0], faixa[1]);
+            __atomic_sub_fetch(&ord->pendentes, 1, __ATOMIC_SEQ_CST);
         }
+        else if (__atomic_load_n(&ord->pendentes, __ATOMIC_SEQ_CST) == 0)
+            break;
+        else
+            sched_yield();
+    }
+    return NULL;
+}
+
+// Procedimento de ordenação paralela de um array inteiro com o método: as
+// estatísticas de cada thread são somadas em stats. Abaixo de LIMIAR_PARTICAO_PARALELA
+// as contagens são idênticas às do quickSort serial (menos nos pivôs R, semeados por
+// faixa: reprodutíveis com qualquer número de threads, mas com outra sequência);
+// acima, os passos da partição paralela substituem os primeiros passos do método.
+// Usa um buffer auxiliar de n inteiros quando há partição paralela. Devolve 0 se
+// faltar memória
+int ordenarParalelo(int *array, int n, int method, int threads, Estatisticas *stats)
+{
+    // Arrays pequenos ou uma thread só: versão serial
+    if (threads <= 1 || n <= 2 * LIMIAR_TAREFA)
+    {
+        quickSort(array, 0, n - 1, method, stats);
+        return 1;
+    }
 
-        // Hoare
-        if(method >= 4)
+    OrdenacaoParalela ord;
+    ord.array = array;
+    ord.method = method;
+    ord.threads = threads;
+    ord.pendentes = 0;
+    ord.qtdFaixas = 1;
+    ord.faixaAtual = 0;
+    ord.parar = 0;
+    ord.stats = calloc(threads, sizeof(Estatisticas));
+    ord.deques = malloc(sizeof(DequeTarefas) * threads);
+    ord.faixasIniciais = malloc(sizeof(int[2]) * (2 * threads + 1));
+    ord.menores = malloc(sizeof(int) * threads);
+    ord.baseMenor = malloc(sizeof(int) * threads);
+    ord.baseMaior = malloc(sizeof(int) * threads);
+    ord.auxiliar = n > LIMIAR_PARTICAO_PARALELA ? malloc(sizeof(int) * n) : NULL;
+    TarefaOrdenacao *tarefas = malloc(sizeof(TarefaOrdenacao) * threads);
+    pthread_t *ids = malloc(sizeof(pthread_t) * threads);
+    int ok = ord.stats && ord.deques && ord.faixasIniciais && ord.menores && ord.baseMenor && ord.baseMaior &&
+             (ord.auxiliar || n <= LIMIAR_PARTICAO_PARALELA) && tarefas && ids;
+
+    if (ok)
+    {
+        // A chamada inicial, como no quickSort serial
+        ord.stats[0].chamadas = 1;
+        ord.faixasIniciais[0][0] = 0;
+        ord.faixasIniciais[0][1] = n - 1;
+        for (int t = 0; t < threads; t++)
         {
-            quickSort(array, low, mid, method, stats);
-            quickSort(array, mid + 1, high, method, stats);
-        } else // Lomuto
+            ord.deques[t].inicio = ord.deques[t].fim = 0;
+            pthread_mutex_init(&ord.deques[t].trava, NULL);
+            tarefas[t].ord = &ord;
+            tarefas[t].id = t;
+        }
+        // Se alguma criação falhar, a ordenação segue só com as threads criadas
+        pthread_mutex_init(&ord.travaLargada, NULL);
+        pthread_cond_init(&ord.sinalLargada, NULL);
+        ord.largada = 0;
+        ord.threads = 1;
+        while (ord.threads < threads && pthread_create(&ids[ord.threads], NULL, ordenacaoTrabalhador, &tarefas[ord.threads]) == 0)
+            ord.threads++;
+        pthread_barrier_init(&ord.barreira, NULL, ord.threads);
+        pthread_mutex_lock(&ord.travaLargada);
+        ord.largada = 1;
+        pthread_cond_broadcast(&ord.sinalLargada);
+        pthread_mutex_unlock(&ord.travaLargada);
+        ordenacaoTrabalhador(&tarefas[0]);
+        for (int t = 1; t < ord.threads; t++)
+            pthread_join(ids[t], NULL);
+        pthread_barrier_destroy(&ord.barreira);
+        pthread_mutex_destroy(&ord.travaLargada);
+        pthread_cond_destroy(&ord.sinalLargada);
+        for (int t = 0; t < threads; t++)
+            pthread_mutex_destroy(&ord.deques[t].trava);
+
+        // Soma as estatísticas das threads
+        for (int t = 0; t < threads; t++)
         {
-            quickSort(array, low, mid - 1, method, stats);
-            quickSort(array, mid + 1, high, method, stats);
+            stats->trocas += ord.stats[t].trocas;
+            stats->chamadas += ord.stats[t].chamadas;
+            stats->comparacoes += ord.stats[t].comparacoes;
         }
     }
+
+    free(ord.stats);
+    free(ord.deques);
+    free(ord.faixasIniciais);
+    free(ord.menores);
+    free(ord.baseMenor);
+    free(ord.baseMaior);
+    free(ord.auxiliar);
+    free(tarefas);
+    free(ids);
+    return ok;
 }
 
 // Ordenação estável usando Insertion Sort
@@ -272,121 +1186,1936 @@ void insertionSort(MetodoResultado *arr, int n)
 }
 
 // Procedimento para escrever resultados no arquivo
-void escreverResultados(FILE* arquivo, MetodoResultado *resultados, int qtdResultados)
+void escreverResultados(FILE* arquivo, MetodoResultado *resultados, int qtdMetodos, int qtdResultados)
 {
     // Escreve os resultados no arquivo
     fprintf(arquivo, "[%d]:", qtdResultados);
-    for (int m = 0; m < 6; m++)
+    for (int m = 0; m < qtdMetodos; m++)
     {
-        fprintf(arquivo, "%s(%d)", resultados[m].nome, resultados[m].custo);
-        if (m < 5) fprintf(arquivo, ",");
+        fprintf(arquivo, "%s(%lld)", resultados[m].nome, resultados[m].custo);
+        if (m < qtdMetodos - 1) fprintf(arquivo, ",");
     }
 }
 
-// Procedimento para processar os dados lidos
-void processarDados(FILE* output, SetArrays dadosLidos, char nomesMetodos[6][3])
+// Configuração de cada contador de hardware (tipo e evento do perf)
+static const struct { uint32_t tipo; uint64_t evento; } eventosHardware[QTD_CONTADORES] = {
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+    {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+};
+
+// Descritores dos contadores de uma thread (-1 quando indisponível)
+typedef struct
 {
-    // Tamanho máximo do array para alocação do buffer
-    int maxSize = 0;
-    // Determina o tamanho máximo entre os arrays
-    for (int i = 0; i < dadosLidos.qtdArrays; i++)
-        if (dadosLidos.arrays[i].size > maxSize)
-            maxSize = dadosLidos.arrays[i].size;
-    
-    // Aloca buffer para ordenação
-    int *buffer = malloc(sizeof(int) * maxSize);
-    if (!buffer)
-    {
-        fprintf(stderr, "Erro ao alocar buffer\n");
-        return;
-    }
+    int fds[QTD_CONTADORES];
+} ContadoresHardware;
 
-    // Processar cada array
-    for (int i = 0; i < dadosLidos.qtdArrays; i++)
+// Procedimento que abre os contadores da thread atual (só modo usuário)
+void abrirContadores(ContadoresHardware *cont)
+{
+    for (int c = 0; c < QTD_CONTADORES; c++)
     {
-        // Armazenar resultados dos métodos
-        MetodoResultado resultados[6];
-        
-        // Testar cada método de ordenação
-        for (int method = 0; method < 6; method++)
-        {
-            // Inicializa estatísticas
-            Estatisticas stats = {0, 0};
-            // Copia o array original para o buffer
-            memcpy(buffer, dadosLidos.arrays[i].array, sizeof(int) * dadosLidos.arrays[i].size);
-            // Executa o QuickSort com o método atual
-            quickSort(buffer, 0, dadosLidos.arrays[i].size - 1, method + 1, &stats);
-            // Armazena o nome do método
-            strcpy(resultados[method].nome, nomesMetodos[method]);
-            // Armazena o número de trocas
-            resultados[method].custo = stats.trocas + stats.chamadas;
-        }
-        
-        // Ordenar de forma estável pelos resultados
-        insertionSort(resultados, 6);
-        // Gerar output no formato especificado
-        escreverResultados(output, resultados, dadosLidos.arrays[i].size);
-        // Nova linha entre os arrays, exceto após o último
-        fprintf(output, "\n");
+        struct perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = eventosHardware[c].tipo;
+        attr.config = eventosHardware[c].evento;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        // pid 0 e cpu -1: mede a thread que abriu, em qualquer núcleo
+        cont->fds[c] = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
     }
+}
 
-    free(buffer);
+// Procedimento que fecha os contadores da thread
+void fecharContadores(ContadoresHardware *cont)
+{
+    for (int c = 0; c < QTD_CONTADORES; c++)
+        if (cont->fds[c] >= 0)
+            close(cont->fds[c]);
 }
 
-// Procedimento para liberar memória
-void liberarSetArrays(SetArrays *set)
+// Procedimento que zera e liga (ligar = 1) ou desliga (ligar = 0) os contadores
+void alternarContadores(ContadoresHardware *cont, int ligar)
 {
-    // Verifica se o set é válido
-    if (set && set->arrays)
+    for (int c = 0; c < QTD_CONTADORES; c++)
+        if (cont->fds[c] >= 0)
+        {
+            if (ligar) ioctl(cont->fds[c], PERF_EVENT_IOC_RESET, 0);
+            ioctl(cont->fds[c], ligar ? PERF_EVENT_IOC_ENABLE : PERF_EVENT_IOC_DISABLE, 0);
+        }
+}
+
+// Procedimento que lê os valores dos contadores para a medição
+void lerContadores(ContadoresHardware *cont, long long *valores)
+{
+    for (int c = 0; c < QTD_CONTADORES; c++)
     {
-        // Libera cada array individualmente
-        for (int i = 0; i < set->qtdArrays; ++i)
-            if (set->arrays[i].array)
-                free(set->arrays[i].array);
+        uint64_t valor;
+        valores[c] = (cont->fds[c] >= 0 && read(cont->fds[c], &valor, sizeof(valor)) == sizeof(valor)) ? (long long)valor : -1;
+    }
+}
+
+// Função que retorna o relógio monotônico em nanossegundos
+long long agoraNs(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+// Função que retorna o pico de memória residente do processo em KB (VmHWM de
+// /proc/self/status), ou -1 se não estiver disponível
+long picoMemoriaKb(void)
+{
+    FILE *status = fopen("/proc/self/status", "r");
+    char linha[256];
+    long kb = -1;
+    if (!status)
+        return -1;
+    while (fgets(linha, sizeof(linha), status))
+        if (sscanf(linha, "VmHWM: %ld", &kb) == 1)
+            break;
+    fclose(status);
+    return kb;
+}
+
+// Função que executa um método sobre uma cópia do array e devolve o resultado;
+// com medicao != NULL também mede tempo e contadores de hardware (no modo
+// paralelo os contadores só enxergam a thread que chama)
+MetodoResultado avaliarMetodo(Array original, int *buffer, int method, Medicao *medicao, ContadoresHardware *cont,
+                              int threadsOrdenacao)
+{
+    MetodoResultado resultado;
+    // Inicializa estatísticas
+    Estatisticas stats = {0, 0, 0};
+    // Copia o array original para o buffer
+    if (original.size > 0)
+        memcpy(buffer, original.array, sizeof(int) * original.size);
+
+    // Executa o QuickSort com o método atual (a cópia fica fora da medição)
+    long long inicio = 0;
+    if (medicao)
+    {
+        alternarContadores(cont, 1);
+        inicio = agoraNs();
+    }
+    if (!ordenarParalelo(buffer, original.size, method, threadsOrdenacao, &stats))
+        fprintf(stderr, "Erro ao alocar buffer\n");
+    if (medicao)
+    {
+        medicao->ns = agoraNs() - inicio;
+        alternarContadores(cont, 0);
+        lerContadores(cont, medicao->contadores);
+        medicao->stats = stats;
+    }
+
+    // Armazena o nome do método
+    strcpy(resultado.nome, nomesMetodos[method - 1]);
+    // Armazena o número de trocas
+    resultado.custo = stats.trocas + stats.chamadas;
+    return resultado;
+}
+
+// Estado compartilhado pelas threads da avaliação paralela
+typedef struct
+{
+    SetArrays dados;
+    SelecaoMetodos metodos;
+    // Pares (array, método) em ordem de execução: tarefa k = array * qtd + posição do método
+    int *ordemTarefas;
+    int totalTarefas;
+    // Próxima tarefa livre da fila (protegida pela trava)
+    int proximaTarefa;
+    pthread_mutex_t trava;
+    int maxSize;
+    // Resultados na posição do par, para escrever na ordem da entrada
+    MetodoResultado *resultados;
+    // Medições por par no modo instrumentado (NULL quando desligado)
+    Medicao *medicoes;
+    // Buffers de ordenação, um por thread, e o próximo a ser entregue (protegido pela trava)
+    int **buffers;
+    int proximoBuffer;
+    // Threads usadas dentro de cada ordenação (modo paralelo)
+    int threadsOrdenacao;
+} AvaliacaoCompartilhada;
+
+// Trabalhador: retira pares (array, método) da fila até esvaziá-la
+void *avaliacaoTrabalhador(void *arg)
+{
+    AvaliacaoCompartilhada *comp = arg;
+    // Buffer de ordenação próprio da thread
+    pthread_mutex_lock(&comp->trava);
+    int *buffer = comp->buffers[comp->proximoBuffer++];
+    pthread_mutex_unlock(&comp->trava);
+    // Contadores de hardware próprios da thread
+    ContadoresHardware cont;
+    if (comp->medicoes)
+        abrirContadores(&cont);
+
+    while (1)
+    {
+        // Retira a próxima tarefa da fila
+        pthread_mutex_lock(&comp->trava);
+        int k = comp->proximaTarefa < comp->totalTarefas ? comp->ordemTarefas[comp->proximaTarefa++] : -1;
+        pthread_mutex_unlock(&comp->trava);
+        if (k < 0)
+            break;
+
+        // Cada tarefa tem suas próprias estatísticas e grava só a sua posição
+        int q = comp->metodos.qtd;
+        comp->resultados[k] = avaliarMetodo(comp->dados.arrays[k / q], buffer, comp->metodos.codigos[k % q],
+                                            comp->medicoes ? &comp->medicoes[k] : NULL, &cont, comp->threadsOrdenacao);
+    }
+
+    if (comp->medicoes)
+        fecharContadores(&cont);
+    return NULL;
+}
+
+// Buffers de ordenação das threads da avaliação; no modo streaming a mesma reserva
+// passa por todos os arrays, sem realocar enquanto o maior tamanho não crescer
+typedef struct
+{
+    int **buffers;
+    int qtd;
+    int capacidade;
+} ReservaBuffers;
+
+// Função que garante qtd buffers de capacidade elementos na reserva; retorna 0 se faltar memória
+int prepararReserva(ReservaBuffers *r, int qtd, int capacidade)
+{
+    if (capacidade < 1)
+        capacidade = 1;
+    // Buffers menores que o necessário são liberados antes de alocar os novos
+    if (capacidade > r->capacidade)
+    {
+        for (int b = 0; b < r->qtd; b++)
+            free(r->buffers[b]);
+        r->qtd = 0;
+        r->capacidade = capacidade;
+    }
+    if (qtd > r->qtd)
+    {
+        int **buffers = realloc(r->buffers, sizeof(int *) * qtd);
+        if (!buffers)
+            return 0;
+        r->buffers = buffers;
+        for (; r->qtd < qtd; r->qtd++)
+            if (!(r->buffers[r->qtd] = malloc(sizeof(int) * r->capacidade)))
+                return 0;
+    }
+    return 1;
+}
+
+void liberarReserva(ReservaBuffers *r)
+{
+    for (int b = 0; b < r->qtd; b++)
+        free(r->buffers[b]);
+    free(r->buffers);
+    r->buffers = NULL;
+    r->qtd = r->capacidade = 0;
+}
+
+// Arrays e métodos por array usados para ordenar a fila (qsort não recebe contexto)
+static Array *arraysTarefas;
+static int metodosTarefas;
+
+// Comparador da fila: arrays maiores primeiro, empate pela ordem da entrada
+int compararTarefas(const void *a, const void *b)
+{
+    int ka = *(const int *)a, kb = *(const int *)b;
+    int sa = arraysTarefas[ka / metodosTarefas].size, sb = arraysTarefas[kb / metodosTarefas].size;
+    if (sa != sb)
+        return sa < sb ? 1 : -1;
+    return (ka > kb) - (ka < kb);
+}
+
+// Nomes das colunas dos contadores de hardware nos arquivos de métricas
+static const char *nomesContadores[QTD_CONTADORES] = {"ciclos", "instrucoes", "falhas_desvio", "falhas_l1d", "falhas_llc"};
+
+// Função que retorna a posição (a partir de 1) do método no ranking já ordenado
+int posicaoRanking(MetodoResultado *ranking, int qtdMetodos, const char *nome)
+{
+    for (int m = 0; m < qtdMetodos; m++)
+        if (strcmp(ranking[m].nome, nome) == 0)
+            return m + 1;
+    return 0;
+}
+
+// Procedimento que escreve o cabeçalho do CSV de métricas
+void escreverCabecalhoCsv(FILE *csv)
+{
+    fprintf(csv, "array,tamanho,metodo,posicao,custo,trocas,chamadas,comparacoes,ns");
+    for (int c = 0; c < QTD_CONTADORES; c++)
+        fprintf(csv, ",%s", nomesContadores[c]);
+    fprintf(csv, ",memoria_kb\n");
+}
+
+// Procedimento que escreve as linhas CSV de um array (uma por método, na ordem da seleção);
+// contadores indisponíveis ficam vazios e memoria_kb é o pico do processo até este array
+void escreverMetricasCsv(FILE *csv, int indice, int tamanho, Medicao *medicoes, MetodoResultado *ranking,
+                         SelecaoMetodos *metodos)
+{
+    long kb = picoMemoriaKb();
+    for (int m = 0; m < metodos->qtd; m++)
+    {
+        Estatisticas *st = &medicoes[m].stats;
+        const char *nome = nomesMetodos[metodos->codigos[m] - 1];
+        fprintf(csv, "%d,%d,%s,%d,%lld,%lld,%lld,%lld,%lld", indice, tamanho, nome,
+                posicaoRanking(ranking, metodos->qtd, nome), st->trocas + st->chamadas,
+                st->trocas, st->chamadas, st->comparacoes, medicoes[m].ns);
+        for (int c = 0; c < QTD_CONTADORES; c++)
+        {
+            if (medicoes[m].contadores[c] >= 0) fprintf(csv, ",%lld", medicoes[m].contadores[c]);
+            else fprintf(csv, ",");
+        }
+        if (kb >= 0) fprintf(csv, ",%ld\n", kb);
+        else fprintf(csv, ",\n");
+    }
+}
+
+// Procedimento que escreve o objeto JSON de um array: a linha de ranking e as métricas
+// por método; contadores indisponíveis saem como null
+void escreverMetricasJson(FILE *json, int indice, int tamanho, Medicao *medicoes, MetodoResultado *ranking,
+                          SelecaoMetodos *metodos)
+{
+    long kb = picoMemoriaKb();
+    fprintf(json, "%s\n  {\"array\": %d, \"tamanho\": %d, \"ranking\": \"", indice ? "," : "", indice, tamanho);
+    escreverResultados(json, ranking, metodos->qtd, tamanho);
+    fprintf(json, "\", \"metodos\": [");
+    for (int m = 0; m < metodos->qtd; m++)
+    {
+        Estatisticas *st = &medicoes[m].stats;
+        const char *nome = nomesMetodos[metodos->codigos[m] - 1];
+        fprintf(json, "%s\n    {\"metodo\": \"%s\", \"posicao\": %d, \"custo\": %lld, \"trocas\": %lld, "
+                "\"chamadas\": %lld, \"comparacoes\": %lld, \"ns\": %lld", m ? "," : "", nome,
+                posicaoRanking(ranking, metodos->qtd, nome), st->trocas + st->chamadas, st->trocas,
+                st->chamadas, st->comparacoes, medicoes[m].ns);
+        for (int c = 0; c < QTD_CONTADORES; c++)
+        {
+            if (medicoes[m].contadores[c] >= 0) fprintf(json, ", \"%s\": %lld", nomesContadores[c], medicoes[m].contadores[c]);
+            else fprintf(json, ", \"%s\": null", nomesContadores[c]);
+        }
+        if (kb >= 0) fprintf(json, ", \"memoria_kb\": %ld}", kb);
+        else fprintf(json, ", \"memoria_kb\": null}");
+    }
+    fprintf(json, "\n  ]}");
+}
+
+// Função para processar os dados lidos; com csv/json != NULL mede cada par
+// (tempo, comparações e contadores de hardware) e grava as métricas, numerando os
+// arrays a partir de indiceInicial (cabeçalho do CSV e colchetes do JSON ficam com
+// quem chama). Com paralelo, as threads trabalham dentro de cada ordenação em vez
+// de em pares diferentes. São usadas no máximo tantas threads quanto pares, cada uma
+// com um buffer do maior array tirado de reserva (NULL: buffers só desta chamada).
+// Retorna 0 em caso de erro
+int processarDados(FILE* output, SetArrays dadosLidos, int indiceInicial, SelecaoMetodos metodos, int threads,
+                   int paralelo, FILE *csv, FILE *json, ReservaBuffers *reserva)
+{
+    // Tamanho máximo do array para alocação dos buffers
+    int maxSize = 0;
+    // Determina o tamanho máximo entre os arrays
+    for (int i = 0; i < dadosLidos.qtdArrays; i++)
+        if (dadosLidos.arrays[i].size > maxSize)
+            maxSize = dadosLidos.arrays[i].size;
+
+    AvaliacaoCompartilhada comp;
+    comp.dados = dadosLidos;
+    comp.metodos = metodos;
+    comp.totalTarefas = dadosLidos.qtdArrays * metodos.qtd;
+    comp.proximaTarefa = 0;
+    comp.maxSize = maxSize;
+    comp.proximoBuffer = 0;
+    // Modo paralelo: um par por vez, ordenado por todas as threads
+    comp.threadsOrdenacao = paralelo ? threads : 1;
+    if (paralelo)
+        threads = 1;
+    // Threads além do número de pares só ocupariam memória com buffers
+    if (threads > comp.totalTarefas)
+        threads = comp.totalTarefas;
+    if (threads < 1)
+        threads = 1;
+    ReservaBuffers local = {NULL, 0, 0};
+    if (!reserva)
+        reserva = &local;
+    comp.ordemTarefas = malloc(sizeof(int) * comp.totalTarefas);
+    comp.resultados = malloc(sizeof(MetodoResultado) * comp.totalTarefas);
+    comp.medicoes = (csv || json) ? malloc(sizeof(Medicao) * comp.totalTarefas) : NULL;
+    pthread_t *ids = malloc(sizeof(pthread_t) * threads);
+    if (!comp.ordemTarefas || !comp.resultados || !ids || ((csv || json) && !comp.medicoes) ||
+        !prepararReserva(reserva, threads, maxSize))
+    {
+        fprintf(stderr, "Erro ao alocar buffer\n");
+        free(comp.ordemTarefas);
+        free(comp.resultados);
+        free(comp.medicoes);
+        free(ids);
+        liberarReserva(&local);
+        return 0;
+    }
+    comp.buffers = reserva->buffers;
+
+    // Arrays maiores entram primeiro na fila para não sobrar uma tarefa longa no fim
+    for (int k = 0; k < comp.totalTarefas; k++)
+        comp.ordemTarefas[k] = k;
+    if (threads > 1)
+    {
+        arraysTarefas = dadosLidos.arrays;
+        metodosTarefas = metodos.qtd;
+        qsort(comp.ordemTarefas, comp.totalTarefas, sizeof(int), compararTarefas);
+    }
+
+    // Pool de threads; a thread principal também trabalha. Se alguma criação falhar,
+    // a fila é esvaziada pelas threads já criadas
+    pthread_mutex_init(&comp.trava, NULL);
+    int criadas = 1;
+    while (criadas < threads && pthread_create(&ids[criadas], NULL, avaliacaoTrabalhador, &comp) == 0)
+        criadas++;
+    avaliacaoTrabalhador(&comp);
+    for (int t = 1; t < criadas; t++)
+        pthread_join(ids[t], NULL);
+    pthread_mutex_destroy(&comp.trava);
+
+    // Avisa (uma vez) quando o sistema não libera nenhum contador de hardware
+    if (indiceInicial == 0 && comp.medicoes && comp.totalTarefas > 0 && comp.medicoes[0].contadores[CONT_CICLOS] < 0)
+        fprintf(stderr, "Aviso: contadores de hardware indisponíveis (perf_event_open); gravando só tempo e contagens\n");
+
+    // Escreve os resultados na ordem da entrada
+    for (int i = 0; i < dadosLidos.qtdArrays; i++)
+    {
+        MetodoResultado *resultados = &comp.resultados[i * metodos.qtd];
+        // Ordenar de forma estável pelos resultados
+        insertionSort(resultados, metodos.qtd);
+        // Gerar output no formato especificado
+        escreverResultados(output, resultados, metodos.qtd, dadosLidos.arrays[i].size);
+        // Nova linha entre os arrays, exceto após o último
+        fprintf(output, "\n");
+
+        // Métricas do mesmo array, ao lado da linha de ranking
+        if (csv) escreverMetricasCsv(csv, indiceInicial + i, dadosLidos.arrays[i].size, &comp.medicoes[i * metodos.qtd],
+                                     resultados, &metodos);
+        if (json) escreverMetricasJson(json, indiceInicial + i, dadosLidos.arrays[i].size,
+                                       &comp.medicoes[i * metodos.qtd], resultados, &metodos);
+    }
+
+    free(comp.ordemTarefas);
+    free(comp.resultados);
+    free(comp.medicoes);
+    free(ids);
+    liberarReserva(&local);
+    return 1;
+}
+
+// Uma das duas vagas do pipeline do modo streaming: um array lido e ainda não avaliado
+typedef struct
+{
+    Array dados;
+    // Elementos alocados em dados.array (0 quando aponta para a entrada binária)
+    int capacidade;
+    // Fim do array na entrada (as páginas até aqui podem ser devolvidas depois da avaliação)
+    size_t fimEntrada;
+    int cheia;
+} VagaStreaming;
+
+// Estado do pipeline: o leitor preenche as vagas alternadamente enquanto a thread
+// principal avalia a outra
+typedef struct
+{
+    Entrada *entrada;
+    // Cabeçalho da entrada binária (NULL no texto)
+    const CabecalhoBinario *binario;
+    int qtdArrays;
+    VagaStreaming vagas[2];
+    pthread_mutex_t trava;
+    pthread_cond_t mudou;
+    // Falha de alocação no leitor: a avaliação para no array em que ela ocorreu
+    int erro;
+    // Erro na avaliação: o leitor para de ler
+    int cancelado;
+    // Início da região da entrada ainda não devolvida ao sistema
+    size_t liberado;
+} PipelineStreaming;
+
+// Procedimento que devolve ao sistema as páginas da entrada já consumidas até fim,
+// de modo que o mapa não acumule o arquivo inteiro na memória residente
+void liberarEntradaAte(PipelineStreaming *p, size_t fim)
+{
+    size_t pagina = (size_t)sysconf(_SC_PAGESIZE);
+    fim -= fim % pagina;
+    if (fim > p->liberado)
+    {
+        madvise((void *)(p->entrada->dados + p->liberado), fim - p->liberado, MADV_DONTNEED);
+        p->liberado = fim;
+    }
+}
+
+// Elementos lidos do texto entre duas devoluções de páginas da entrada
+#define LOTE_LIBERACAO_TEXTO (1 << 18)
+
+// Função que lê o array seguinte na vaga; retorna 0 se faltou memória
+int lerArrayStreaming(PipelineStreaming *p, int indice, VagaStreaming *vaga)
+{
+    if (p->binario)
+    {
+        // Binário: sem cópia, só aponta para os elementos no mapa
+        const int32_t *tamanhos = (const int32_t *)(p->entrada->dados + sizeof(CabecalhoBinario));
+        vaga->dados.size = tamanhos[indice];
+        vaga->dados.array = tamanhos[indice] > 0 ? (int *)(p->entrada->dados + p->entrada->pos) : NULL;
+        p->entrada->pos += sizeof(int32_t) * (size_t)tamanhos[indice];
+        vaga->fimEntrada = p->entrada->pos;
+        return 1;
+    }
+
+    // Texto: tamanhos ilegíveis viram arrays vazios e negativos ficam sem elementos
+    int n;
+    if (!lerInteiro(p->entrada, &n))
+        n = 0;
+    vaga->dados.size = n;
+    if (n > vaga->capacidade)
+    {
+        free(vaga->dados.array);
+        vaga->dados.array = malloc(sizeof(int) * n);
+        vaga->capacidade = vaga->dados.array ? n : 0;
+        if (!vaga->dados.array)
+            return 0;
+    }
+    for (int j = 0; j < n; j++)
+    {
+        if (!lerInteiro(p->entrada, &vaga->dados.array[j]))
+            vaga->dados.array[j] = 0;
+        // O texto já convertido é devolvido aos poucos, sem esperar o array inteiro
+        if ((j & (LOTE_LIBERACAO_TEXTO - 1)) == LOTE_LIBERACAO_TEXTO - 1)
+            liberarEntradaAte(p, p->entrada->pos);
+    }
+    // O texto do array já foi copiado: suas páginas podem ser devolvidas
+    liberarEntradaAte(p, p->entrada->pos);
+    vaga->fimEntrada = p->entrada->pos;
+    return 1;
+}
+
+// Leitor do pipeline: preenche as vagas em alternância, esperando cada uma esvaziar
+void *leitorStreaming(void *arg)
+{
+    PipelineStreaming *p = arg;
+    for (int i = 0; i < p->qtdArrays; i++)
+    {
+        VagaStreaming *vaga = &p->vagas[i % 2];
+        pthread_mutex_lock(&p->trava);
+        while (vaga->cheia && !p->cancelado)
+            pthread_cond_wait(&p->mudou, &p->trava);
+        int cancelado = p->cancelado;
+        pthread_mutex_unlock(&p->trava);
+        if (cancelado)
+            break;
+
+        int ok = lerArrayStreaming(p, i, vaga);
+
+        pthread_mutex_lock(&p->trava);
+        if (!ok)
+            p->erro = 1;
+        vaga->cheia = ok;
+        pthread_cond_broadcast(&p->mudou);
+        pthread_mutex_unlock(&p->trava);
+        if (!ok)
+            break;
+    }
+    return NULL;
+}
+
+// Função do modo streaming: avalia um array por vez, na ordem da entrada, com a
+// leitura do próximo sobreposta à avaliação do atual (duas vagas). Qualquer que seja
+// o número de arrays, a memória fica em torno de (2 + B) vezes o maior array no texto
+// e (1 + B) no binário, cujas vagas apontam para o mapa; B = min(threads, métodos) é o
+// número de buffers da avaliação, reaproveitados entre os arrays (com --paralelo, B = 1
+// mais o buffer auxiliar da partição paralela). Se a thread leitora não puder ser
+// criada, a leitura é feita antes de cada avaliação, sem sobreposição.
+// Retorna -1 se a entrada não tem arrays e 0 em caso de erro
+int processarStreaming(Entrada *entrada, FILE *output, SelecaoMetodos metodos, int threads, int paralelo,
+                       FILE *csv, FILE *json)
+{
+    PipelineStreaming p;
+    memset(&p, 0, sizeof(p));
+    p.entrada = entrada;
+    if (entradaBinaria(entrada))
+    {
+        p.binario = validarBinario(entrada);
+        if (!p.binario)
+            return -1;
+        p.qtdArrays = (int)p.binario->qtdArrays;
+        entrada->pos = p.binario->offDados;
+    } else if (!lerInteiro(entrada, &p.qtdArrays) || p.qtdArrays <= 0)
+        return -1;
+
+    pthread_mutex_init(&p.trava, NULL);
+    pthread_cond_init(&p.mudou, NULL);
+    pthread_t leitor;
+    int temLeitor = pthread_create(&leitor, NULL, leitorStreaming, &p) == 0;
+    ReservaBuffers reserva = {NULL, 0, 0};
+
+    int ok = 1;
+    for (int i = 0; i < p.qtdArrays && ok; i++)
+    {
+        VagaStreaming *vaga = &p.vagas[i % 2];
+        if (!temLeitor)
+        {
+            vaga->cheia = lerArrayStreaming(&p, i, vaga);
+            p.erro = !vaga->cheia;
+        }
+        pthread_mutex_lock(&p.trava);
+        while (!vaga->cheia && !p.erro)
+            pthread_cond_wait(&p.mudou, &p.trava);
+        ok = vaga->cheia;
+        pthread_mutex_unlock(&p.trava);
+        if (!ok)
+        {
+            fprintf(stderr, "Erro ao alocar buffer\n");
+            break;
+        }
+
+        // Avalia o array como um conjunto de um só, com o índice da entrada
+        SetArrays atual = {&vaga->dados, 1, NULL, 0};
+        ok = processarDados(output, atual, i, metodos, threads, paralelo, csv, json, &reserva);
+        // Binário: os elementos avaliados não voltam a ser lidos
+        if (p.binario)
+            liberarEntradaAte(&p, vaga->fimEntrada);
+
+        pthread_mutex_lock(&p.trava);
+        vaga->cheia = 0;
+        pthread_cond_broadcast(&p.mudou);
+        pthread_mutex_unlock(&p.trava);
+    }
+
+    // Em caso de erro o leitor pode estar esperando uma vaga
+    pthread_mutex_lock(&p.trava);
+    p.cancelado = !ok;
+    pthread_cond_broadcast(&p.mudou);
+    pthread_mutex_unlock(&p.trava);
+    if (temLeitor)
+        pthread_join(leitor, NULL);
+    liberarReserva(&reserva);
+    pthread_cond_destroy(&p.mudou);
+    pthread_mutex_destroy(&p.trava);
+    free(p.vagas[0].capacidade ? p.vagas[0].dados.array : NULL);
+    free(p.vagas[1].capacidade ? p.vagas[1].dados.array : NULL);
+    return ok;
+}
+
+// Bloco mínimo de cada corrida na intercalação: abaixo dele as leituras deixam de ser
+// sequenciais grandes e compensa fazer mais uma passada com menos corridas por vez
+#define BLOCO_MIN_INTERCALACAO (1 << 20)
+
+// Pedido de leitura (pread) ou escrita (pwrite) atendido pela thread de E/S
+typedef struct PedidoES
+{
+    int fd;
+    int escrita;
+    char *dados;
+    size_t tamanho;
+    off_t posicao;
+    // pronto = 1 depois de atendido; ok = 0 se houve erro ou o arquivo acabou antes
+    int pronto;
+    int ok;
+    struct PedidoES *proximo;
+} PedidoES;
+
+// Thread de E/S do modo externo: atende os pedidos na ordem de chegada, enquanto a
+// ordenação das corridas e a intercalação continuam na thread principal
+typedef struct
+{
+    pthread_t thread;
+    pthread_mutex_t trava;
+    pthread_cond_t novoPedido;
+    pthread_cond_t atendido;
+    PedidoES *primeiro;
+    PedidoES *ultimo;
+    int encerrar;
+    // Sem a thread de E/S (criação falhou), cada pedido é atendido ao ser enviado
+    int sincrono;
+} ServicoES;
+
+// Função que transfere todos os bytes de um pedido; retorna 0 em caso de erro
+int transferirPedido(PedidoES *p)
+{
+    size_t feito = 0;
+    while (feito < p->tamanho)
+    {
+        ssize_t n = p->escrita ? pwrite(p->fd, p->dados + feito, p->tamanho - feito, p->posicao + (off_t)feito)
+                               : pread(p->fd, p->dados + feito, p->tamanho - feito, p->posicao + (off_t)feito);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return 0;
+        feito += (size_t)n;
+    }
+    return 1;
+}
+
+// Thread de E/S: retira pedidos da fila até o encerramento com a fila vazia
+void *trabalhadorES(void *arg)
+{
+    ServicoES *s = arg;
+    pthread_mutex_lock(&s->trava);
+    while (1)
+    {
+        while (!s->primeiro && !s->encerrar)
+            pthread_cond_wait(&s->novoPedido, &s->trava);
+        if (!s->primeiro)
+            break;
+        PedidoES *p = s->primeiro;
+        s->primeiro = p->proximo;
+        if (!s->primeiro)
+            s->ultimo = NULL;
+        pthread_mutex_unlock(&s->trava);
+
+        int ok = transferirPedido(p);
+
+        pthread_mutex_lock(&s->trava);
+        p->ok = ok;
+        p->pronto = 1;
+        pthread_cond_broadcast(&s->atendido);
+    }
+    pthread_mutex_unlock(&s->trava);
+    return NULL;
+}
+
+// Procedimento que inicia a thread de E/S; se ela não puder ser criada, o serviço
+// atende cada pedido de forma síncrona em enviarPedido
+void iniciarServicoES(ServicoES *s)
+{
+    s->primeiro = s->ultimo = NULL;
+    s->encerrar = 0;
+    pthread_mutex_init(&s->trava, NULL);
+    pthread_cond_init(&s->novoPedido, NULL);
+    pthread_cond_init(&s->atendido, NULL);
+    s->sincrono = pthread_create(&s->thread, NULL, trabalhadorES, s) != 0;
+}
+
+// Procedimento que encerra a thread de E/S depois de atender os pedidos pendentes
+void encerrarServicoES(ServicoES *s)
+{
+    pthread_mutex_lock(&s->trava);
+    s->encerrar = 1;
+    pthread_cond_signal(&s->novoPedido);
+    pthread_mutex_unlock(&s->trava);
+    if (!s->sincrono)
+        pthread_join(s->thread, NULL);
+    pthread_cond_destroy(&s->atendido);
+    pthread_cond_destroy(&s->novoPedido);
+    pthread_mutex_destroy(&s->trava);
+}
+
+// Procedimento que marca um pedido como atendido sem transferir nada (estado inicial)
+void pedidoVazio(PedidoES *p)
+{
+    memset(p, 0, sizeof(*p));
+    p->pronto = 1;
+    p->ok = 1;
+}
+
+// Procedimento que coloca um pedido na fila da thread de E/S; pedidos sem bytes já
+// nascem atendidos. Os dados não podem ser tocados até aguardarPedido
+void enviarPedido(ServicoES *s, PedidoES *p, int fd, int escrita, void *dados, size_t tamanho, off_t posicao)
+{
+    pedidoVazio(p);
+    if (tamanho == 0)
+        return;
+    p->fd = fd;
+    p->escrita = escrita;
+    p->dados = dados;
+    p->tamanho = tamanho;
+    p->posicao = posicao;
+    if (s->sincrono)
+    {
+        p->ok = transferirPedido(p);
+        return;
+    }
+    p->pronto = 0;
+    pthread_mutex_lock(&s->trava);
+    if (s->ultimo)
+        s->ultimo->proximo = p;
+    else
+        s->primeiro = p;
+    s->ultimo = p;
+    pthread_cond_signal(&s->novoPedido);
+    pthread_mutex_unlock(&s->trava);
+}
+
+// Função que espera o atendimento de um pedido; retorna 0 em caso de erro de E/S
+int aguardarPedido(ServicoES *s, PedidoES *p)
+{
+    pthread_mutex_lock(&s->trava);
+    while (!p->pronto)
+        pthread_cond_wait(&s->atendido, &s->trava);
+    int ok = p->ok;
+    pthread_mutex_unlock(&s->trava);
+    return ok;
+}
+
+// Corrida ordenada gravada num arquivo temporário
+typedef struct
+{
+    off_t posicao;
+    long long qtd;
+} Corrida;
+
+// Leitura de uma corrida na intercalação, em dois blocos: enquanto um é consumido,
+// a thread de E/S lê o seguinte
+typedef struct
+{
+    PedidoES pedidos[2];
+    int *blocos[2];
+    int qtdBloco[2];
+    int capacidade;
+    int fd;
+    // Posição e quantidade do que ainda não foi pedido
+    off_t proxima;
+    long long restantes;
+    // Bloco em consumo e próxima posição nele; a corrida acabou quando pos == qtdBloco[atual]
+    int atual;
+    int pos;
+} LeitorCorrida;
+
+// Procedimento que pede o próximo trecho da corrida no bloco b
+void pedirBloco(ServicoES *s, LeitorCorrida *l, int b)
+{
+    int n = l->restantes < l->capacidade ? (int)l->restantes : l->capacidade;
+    l->qtdBloco[b] = n;
+    enviarPedido(s, &l->pedidos[b], l->fd, 0, l->blocos[b], sizeof(int) * (size_t)n, l->proxima);
+    l->proxima += (off_t)sizeof(int) * n;
+    l->restantes -= n;
+}
+
+// Função que passa ao bloco já pedido e reaproveita o consumido para o trecho
+// seguinte; retorna 0 em caso de erro de leitura
+int trocarBloco(ServicoES *s, LeitorCorrida *l)
+{
+    int outro = 1 - l->atual;
+    if (!aguardarPedido(s, &l->pedidos[outro]))
+        return 0;
+    pedirBloco(s, l, l->atual);
+    l->atual = outro;
+    l->pos = 0;
+    return 1;
+}
+
+// Função que indica se a corrida a vence a corrida b na árvore de perdedores: a folha
+// virtual k (só usada na montagem) vence todas, corridas esgotadas perdem para todas
+// e o empate fica com a de menor índice
+static inline int venceCorrida(LeitorCorrida *l, int k, int a, int b)
+{
+    if (a == k || b == k)
+        return a == k;
+    int fimA = l[a].pos == l[a].qtdBloco[l[a].atual];
+    int fimB = l[b].pos == l[b].qtdBloco[l[b].atual];
+    if (fimA != fimB)
+        return fimB;
+    if (!fimA)
+    {
+        int va = l[a].blocos[l[a].atual][l[a].pos];
+        int vb = l[b].blocos[l[b].atual][l[b].pos];
+        if (va != vb)
+            return va < vb;
+    }
+    return a < b;
+}
+
+// Procedimento que sobe a folha s até a raiz: cada nó guarda o perdedor do seu jogo e
+// arvore[0] fica com o vencedor geral (log2 k comparações por elemento)
+static inline void ajustarArvore(LeitorCorrida *l, int *arvore, int k, int s)
+{
+    for (int t = (s + k) / 2; t > 0; t /= 2)
+        if (venceCorrida(l, k, arvore[t], s))
+        {
+            int perdedor = s;
+            s = arvore[t];
+            arvore[t] = perdedor;
+        }
+    arvore[0] = s;
+}
+
+// Função que intercala k corridas de fdOrigem com uma árvore de perdedores e grava o
+// resultado em fdDestino a partir de destino; cada corrida e a saída têm dois blocos
+// de E/S assíncrona dentro de memoria bytes. Retorna 0 em caso de erro
+int intercalarCorridas(ServicoES *s, int fdOrigem, const Corrida *corridas, int k, int fdDestino, off_t destino,
+                       size_t memoria)
+{
+    size_t bloco = memoria / sizeof(int) / (2 * (size_t)(k + 1));
+    if (bloco < 1024) bloco = 1024;
+    if (bloco > INT32_MAX / 2) bloco = INT32_MAX / 2;
+    LeitorCorrida *leitores = malloc(sizeof(LeitorCorrida) * k);
+    int *arvore = malloc(sizeof(int) * k);
+    int *blocos = malloc(sizeof(int) * bloco * 2 * (k + 1));
+    if (!leitores || !arvore || !blocos)
+    {
+        fprintf(stderr, "Erro ao alocar buffer\n");
+        free(leitores);
+        free(arvore);
+        free(blocos);
+        return 0;
+    }
+
+    int ok = 1;
+    for (int c = 0; c < k; c++)
+    {
+        LeitorCorrida *l = &leitores[c];
+        l->blocos[0] = blocos + bloco * 2 * c;
+        l->blocos[1] = l->blocos[0] + bloco;
+        l->capacidade = (int)bloco;
+        l->fd = fdOrigem;
+        l->proxima = corridas[c].posicao;
+        l->restantes = corridas[c].qtd;
+        l->atual = 0;
+        l->pos = 0;
+        pedirBloco(s, l, 0);
+        pedirBloco(s, l, 1);
+    }
+    for (int c = 0; c < k; c++)
+        ok &= aguardarPedido(s, &leitores[c].pedidos[0]);
+
+    // Saída em dois blocos: um é preenchido enquanto o outro é gravado
+    int *saida[2] = {blocos + bloco * 2 * k, blocos + bloco * (2 * k + 1)};
+    PedidoES gravacoes[2];
+    pedidoVazio(&gravacoes[0]);
+    pedidoVazio(&gravacoes[1]);
+    int atual = 0;
+    size_t usado = 0;
+
+    // Montagem: todos os nós começam com a folha virtual, que sai pela raiz
+    for (int t = 0; t < k; t++)
+        arvore[t] = k;
+    for (int c = k - 1; c >= 0; c--)
+        ajustarArvore(leitores, arvore, k, c);
+
+    while (ok)
+    {
+        int v = arvore[0];
+        LeitorCorrida *l = &leitores[v];
+        // O vencedor esgotado indica que todas acabaram
+        if (l->pos == l->qtdBloco[l->atual])
+            break;
+        saida[atual][usado++] = l->blocos[l->atual][l->pos++];
+        if (usado == bloco)
+        {
+            enviarPedido(s, &gravacoes[atual], fdDestino, 1, saida[atual], sizeof(int) * usado, destino);
+            destino += (off_t)(sizeof(int) * usado);
+            atual = 1 - atual;
+            usado = 0;
+            ok = aguardarPedido(s, &gravacoes[atual]);
+        }
+        if (l->pos == l->qtdBloco[l->atual] && !trocarBloco(s, l))
+            ok = 0;
+        ajustarArvore(leitores, arvore, k, v);
+    }
+    if (ok)
+        enviarPedido(s, &gravacoes[atual], fdDestino, 1, saida[atual], sizeof(int) * usado, destino);
+
+    // Nenhum buffer é liberado com pedido pendente
+    ok &= aguardarPedido(s, &gravacoes[0]);
+    ok &= aguardarPedido(s, &gravacoes[1]);
+    for (int c = 0; c < k; c++)
+    {
+        aguardarPedido(s, &leitores[c].pedidos[0]);
+        aguardarPedido(s, &leitores[c].pedidos[1]);
+    }
+    free(leitores);
+    free(arvore);
+    free(blocos);
+    return ok;
+}
+
+// Estado do modo externo compartilhado pelos arrays da entrada
+typedef struct
+{
+    ServicoES es;
+    int fdEntrada;
+    // Arquivo binário dos arrays ordenados (-1 sem --ordenado)
+    int fdSaida;
+    const char *pastaTemp;
+    size_t memoria;
+    // Elementos por corrida: memoria dividida em 4 buffers (leitura dupla, ordenação e
+    // gravação), mesmo sem --ordenado, para o ranking não depender da gravação
+    long long capacidadeCorrida;
+    SelecaoMetodos metodos;
+    int threadsOrdenacao;
+    // Contadores de hardware da thread principal (só com métricas)
+    int medir;
+    ContadoresHardware cont;
+} ContextoExterno;
+
+// Função que cria um arquivo temporário já removido do diretório (some ao ser
+// fechado, mesmo se o programa for interrompido); retorna -1 em caso de erro
+int criarTemporario(const char *pasta)
+{
+    char caminho[4096];
+    if (snprintf(caminho, sizeof(caminho), "%s/quicksortXXXXXX", pasta) >= (int)sizeof(caminho))
+        return -1;
+    int fd = mkstemp(caminho);
+    if (fd >= 0)
+        unlink(caminho);
+    return fd;
+}
+
+// Procedimento que soma a medição de uma corrida à do array; um contador
+// indisponível em alguma corrida fica indisponível no total
+void somarMedicao(Medicao *total, const Medicao *parcial, int primeira)
+{
+    if (primeira)
+    {
+        *total = *parcial;
+        return;
+    }
+    total->stats.trocas += parcial->stats.trocas;
+    total->stats.chamadas += parcial->stats.chamadas;
+    total->stats.comparacoes += parcial->stats.comparacoes;
+    total->ns += parcial->ns;
+    for (int c = 0; c < QTD_CONTADORES; c++)
+        total->contadores[c] = total->contadores[c] >= 0 && parcial->contadores[c] >= 0
+                                   ? total->contadores[c] + parcial->contadores[c] : -1;
+}
+
+// Função que intercala as k corridas de fd em fdSaida a partir de destino; com mais
+// corridas do que cabem numa intercalação, faz passadas intermediárias em novos
+// arquivos temporários. Retorna 0 em caso de erro
+int intercalarPassadas(ContextoExterno *ctx, int fd, long long n, int k, off_t destino)
+{
+    int maxCorridas = (int)(ctx->memoria / (2 * (size_t)BLOCO_MIN_INTERCALACAO)) - 1;
+    if (maxCorridas < 2) maxCorridas = 2;
+    Corrida *corridas = malloc(sizeof(Corrida) * k);
+    if (!corridas)
+    {
+        fprintf(stderr, "Erro ao alocar buffer\n");
+        return 0;
+    }
+    for (int c = 0; c < k; c++)
+    {
+        long long inicio = c * ctx->capacidadeCorrida;
+        corridas[c].posicao = (off_t)(sizeof(int) * inicio);
+        corridas[c].qtd = n - inicio < ctx->capacidadeCorrida ? n - inicio : ctx->capacidadeCorrida;
+    }
+
+    int ok = 1;
+    int origem = fd;
+    while (ok && k > maxCorridas)
+    {
+        int novo = criarTemporario(ctx->pastaTemp);
+        if (novo < 0)
+        {
+            fprintf(stderr, "Erro ao criar arquivo temporário em %s\n", ctx->pastaTemp);
+            ok = 0;
+            break;
+        }
+        // Grupos consecutivos viram uma corrida cada, no novo arquivo
+        int novas = 0;
+        off_t posicao = 0;
+        for (int g = 0; g < k && ok; g += maxCorridas)
+        {
+            int q = k - g < maxCorridas ? k - g : maxCorridas;
+            long long total = 0;
+            for (int c = g; c < g + q; c++)
+                total += corridas[c].qtd;
+            ok = intercalarCorridas(&ctx->es, origem, corridas + g, q, novo, posicao, ctx->memoria);
+            corridas[novas].posicao = posicao;
+            corridas[novas].qtd = total;
+            novas++;
+            posicao += (off_t)(sizeof(int) * total);
+        }
+        if (origem != fd)
+            close(origem);
+        origem = novo;
+        k = novas;
+    }
+    if (ok)
+        ok = intercalarCorridas(&ctx->es, origem, corridas, k, ctx->fdSaida, destino, ctx->memoria);
+    if (origem != fd)
+        close(origem);
+    free(corridas);
+    return ok;
+}
+
+// Função que avalia um array do modo externo: divide-o em corridas que cabem na
+// memória, com a leitura da próxima sobreposta à avaliação da atual, e avalia cada
+// corrida com todos os métodos (custos e medições somados entre as corridas). Com
+// --ordenado, a corrida ordenada pelo último método é gravada em segundo plano e as
+// corridas são intercaladas em destino. Retorna 0 em caso de erro
+int ordenarArrayExterno(ContextoExterno *ctx, long long n, off_t origem, off_t destino, MetodoResultado *resultados,
+                        Medicao *medicoes)
+{
+    int gravar = ctx->fdSaida >= 0;
+    long long capacidade = n < ctx->capacidadeCorrida ? (n > 0 ? n : 1) : ctx->capacidadeCorrida;
+    // Um array vazio ainda é avaliado (uma corrida vazia), como fora do modo externo
+    int k = n > 0 ? (int)((n + capacidade - 1) / capacidade) : 1;
+    int *buffers = malloc(sizeof(int) * capacidade * (gravar ? 4 : 3));
+    int fdTemp = gravar && k > 1 ? criarTemporario(ctx->pastaTemp) : -1;
+    if (!buffers || (gravar && k > 1 && fdTemp < 0))
+    {
+        if (!buffers) fprintf(stderr, "Erro ao alocar buffer\n");
+        else fprintf(stderr, "Erro ao criar arquivo temporário em %s\n", ctx->pastaTemp);
+        free(buffers);
+        if (fdTemp >= 0) close(fdTemp);
+        return 0;
+    }
+    int *leitura[2] = {buffers, buffers + capacidade};
+    int *trabalho = buffers + 2 * capacidade;
+    int *escrita = gravar ? buffers + 3 * capacidade : NULL;
+    PedidoES leituras[2], gravacao;
+    pedidoVazio(&gravacao);
+
+    // Pede as duas primeiras corridas; as seguintes são pedidas quando um buffer vaga
+    int ok = 1;
+    for (int c = 0; c < 2; c++)
+    {
+        long long inicio = c * capacidade;
+        long long qtd = c < k ? (n - inicio < capacidade ? n - inicio : capacidade) : 0;
+        enviarPedido(&ctx->es, &leituras[c], ctx->fdEntrada, 0, leitura[c], sizeof(int) * qtd,
+                     origem + (off_t)(sizeof(int) * inicio));
+    }
+
+    for (int c = 0; c < k && ok; c++)
+    {
+        int b = c % 2;
+        long long inicio = c * capacidade;
+        Array corrida = {leitura[b], (int)(n - inicio < capacidade ? n - inicio : capacidade)};
+        if (!aguardarPedido(&ctx->es, &leituras[b]))
+        {
+            ok = 0;
+            break;
+        }
+
+        for (int m = 0; m < ctx->metodos.qtd; m++)
+        {
+            Medicao medicao;
+            MetodoResultado r = avaliarMetodo(corrida, trabalho, ctx->metodos.codigos[m], ctx->medir ? &medicao : NULL,
+                                              &ctx->cont, ctx->threadsOrdenacao);
+            if (c == 0)
+                resultados[m] = r;
+            else
+                resultados[m].custo += r.custo;
+            if (ctx->medir)
+                somarMedicao(&medicoes[m], &medicao, c == 0);
+        }
+
+        // A cópia da corrida já foi ordenada por todos: o buffer de leitura fica livre
+        if (c + 2 < k)
+        {
+            long long proxima = (c + 2) * capacidade;
+            long long qtd = n - proxima < capacidade ? n - proxima : capacidade;
+            enviarPedido(&ctx->es, &leituras[b], ctx->fdEntrada, 0, leitura[b], sizeof(int) * qtd,
+                         origem + (off_t)(sizeof(int) * proxima));
+        }
+
+        // Grava a corrida ordenada enquanto a próxima é avaliada; uma corrida só vai direto ao destino
+        if (gravar)
+        {
+            ok = aguardarPedido(&ctx->es, &gravacao);
+            int *ordenada = trabalho;
+            trabalho = escrita;
+            escrita = ordenada;
+            enviarPedido(&ctx->es, &gravacao, k > 1 ? fdTemp : ctx->fdSaida, 1, escrita, sizeof(int) * corrida.size,
+                         k > 1 ? (off_t)(sizeof(int) * inicio) : destino);
+        }
+    }
+
+    ok &= aguardarPedido(&ctx->es, &gravacao);
+    aguardarPedido(&ctx->es, &leituras[0]);
+    aguardarPedido(&ctx->es, &leituras[1]);
+    if (!ok)
+        fprintf(stderr, "Erro de leitura ou gravação no modo externo\n");
+    // Os buffers das corridas saem antes da intercalação, que usa a mesma memória
+    free(buffers);
+    if (ok && gravar && k > 1)
+        ok = intercalarPassadas(ctx, fdTemp, n, k, destino);
+    if (fdTemp >= 0)
+        close(fdTemp);
+    return ok;
+}
+
+// Função do modo externo (--externo): avalia arrays maiores que a memória em
+// corridas de até memoria bytes, lendo a entrada binária com pread em vez do mapa,
+// e, com caminhoOrdenado, grava os arrays ordenados num arquivo binário com o mesmo
+// cabeçalho, intercalando as corridas a partir de pastaTemp. O ranking e as métricas
+// somam as corridas (com uma corrida só, coincidem com o modo normal). Retorna -1 se
+// a entrada não é binária válida e 0 em caso de erro
+int processarExterno(Entrada *entrada, const char *caminhoEntrada, FILE *output, SelecaoMetodos metodos, int threads,
+                     int paralelo, size_t memoria, const char *caminhoOrdenado, const char *pastaTemp, FILE *csv,
+                     FILE *json)
+{
+    if (!entradaBinaria(entrada))
+    {
+        fprintf(stderr, "O modo externo exige a entrada binária (gere-a com --converter=binario).\n");
+        return -1;
+    }
+    const CabecalhoBinario *cab = validarBinario(entrada);
+    if (!cab)
+        return -1;
+    const int32_t *tamanhos = (const int32_t *)(entrada->dados + sizeof(CabecalhoBinario));
+
+    ContextoExterno ctx;
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.fdEntrada = open(caminhoEntrada, O_RDONLY);
+    ctx.fdSaida = caminhoOrdenado ? open(caminhoOrdenado, O_WRONLY | O_CREAT | O_TRUNC, 0644) : -1;
+    if (ctx.fdEntrada < 0 || (caminhoOrdenado && ctx.fdSaida < 0))
+    {
+        printf("Erro ao abrir arquivos.\n");
+        if (ctx.fdEntrada >= 0) close(ctx.fdEntrada);
+        if (ctx.fdSaida >= 0) close(ctx.fdSaida);
+        return 0;
+    }
+    ctx.pastaTemp = pastaTemp ? pastaTemp : (getenv("TMPDIR") ? getenv("TMPDIR") : "/tmp");
+    ctx.memoria = memoria;
+    ctx.capacidadeCorrida = (long long)(memoria / sizeof(int) / 4);
+    if (ctx.capacidadeCorrida > INT32_MAX) ctx.capacidadeCorrida = INT32_MAX;
+    ctx.metodos = metodos;
+    ctx.threadsOrdenacao = paralelo ? threads : 1;
+    ctx.medir = csv || json;
+    if (ctx.medir)
+        abrirContadores(&ctx.cont);
+
+    MetodoResultado *resultados = malloc(sizeof(MetodoResultado) * metodos.qtd);
+    Medicao *medicoes = malloc(sizeof(Medicao) * metodos.qtd);
+    int ok = resultados && medicoes;
+    if (!ok)
+        fprintf(stderr, "Erro ao alocar buffer\n");
+
+    // O arquivo ordenado tem o mesmo cabeçalho e os arrays nas mesmas posições
+    if (ok && caminhoOrdenado)
+    {
+        PedidoES cabecalho;
+        pedidoVazio(&cabecalho);
+        cabecalho.fd = ctx.fdSaida;
+        cabecalho.escrita = 1;
+        cabecalho.dados = (char *)entrada->dados;
+        cabecalho.tamanho = cab->offDados;
+        ok = transferirPedido(&cabecalho);
+        if (!ok)
+            fprintf(stderr, "Erro de leitura ou gravação no modo externo\n");
+    }
+
+    iniciarServicoES(&ctx.es);
+    off_t posicao = (off_t)cab->offDados;
+    for (uint32_t i = 0; ok && i < cab->qtdArrays; i++)
+    {
+        ok = ordenarArrayExterno(&ctx, tamanhos[i], posicao, posicao, resultados, medicoes);
+        if (!ok)
+            break;
+        posicao += (off_t)(sizeof(int) * (size_t)tamanhos[i]);
+
+        if (i == 0 && ctx.medir && metodos.qtd > 0 && medicoes[0].contadores[CONT_CICLOS] < 0)
+            fprintf(stderr, "Aviso: contadores de hardware indisponíveis (perf_event_open); gravando só tempo e contagens\n");
+        // Ranking e métricas como no modo normal
+        insertionSort(resultados, metodos.qtd);
+        escreverResultados(output, resultados, metodos.qtd, tamanhos[i]);
+        fprintf(output, "\n");
+        if (csv) escreverMetricasCsv(csv, (int)i, tamanhos[i], medicoes, resultados, &metodos);
+        if (json) escreverMetricasJson(json, (int)i, tamanhos[i], medicoes, resultados, &metodos);
+    }
+    encerrarServicoES(&ctx.es);
+
+    if (ctx.medir)
+        fecharContadores(&ctx.cont);
+    close(ctx.fdEntrada);
+    if (ctx.fdSaida >= 0 && close(ctx.fdSaida) != 0)
+        ok = 0;
+    free(resultados);
+    free(medicoes);
+    return ok;
+}
+
+// Gera o processamento de entradas com chaves de outro tipo (--tipo): cada array é
+// lido com LER(arquivo, &elemento), que devolve 1 se leu, e ordenado em série por
+// cada método selecionado com o ordenador especializado NOME##XX; o ranking e o
+// formato da saída são os do modo int. Devolve 0 se a entrada não tem arrays
+#define DEFINIR_PROCESSAMENTO_TIPO(NOME, TIPO, LER)                                          \
+int NOME##Processar(FILE *input, FILE *output, SelecaoMetodos metodos)                       \
+{                                                                                            \
+    /* Ordenadores por código; o método VM só existe para int */                             \
+    void (*const ordenadores[QTD_METODOS])(TIPO *, int, int, Estatisticas *) = {             \
+        NOME##LP, NOME##LM, NOME##LA, NOME##HP, NOME##HM, NOME##HA,                          \
+        NOME##BM, NOME##BA, NOME##TV, NOME##DP, NULL, NOME##PD,                              \
+        NOME##LR, NOME##LN, NOME##LS, NOME##LD, NOME##HR, NOME##HN, NOME##HS, NOME##HD,      \
+        NOME##BR, NOME##BN, NOME##BS, NOME##BD, NOME##TR, NOME##TN, NOME##TS, NOME##TD,      \
+        NOME##DR, NOME##DN, NOME##DS, NOME##DD                                               \
+    };                                                                                       \
+    int qtdArrays;                                                                           \
+    if (fscanf(input, "%d", &qtdArrays) != 1 || qtdArrays <= 0)                              \
+        return 0;                                                                            \
+    TIPO *original = NULL, *buffer = NULL;                                                   \
+    int capacidade = 0;                                                                      \
+    MetodoResultado resultados[QTD_METODOS];                                                 \
+    for (int i = 0; i < qtdArrays; i++)                                                      \
+    {                                                                                        \
+        /* Tamanhos inválidos viram arrays vazios */                                         \
+        int n;                                                                               \
+        if (fscanf(input, "%d", &n) != 1 || n < 0)                                           \
+            n = 0;                                                                           \
+        if (n > capacidade)                                                                  \
+        {                                                                                    \
+            free(original);                                                                  \
+            free(buffer);                                                                    \
+            original = malloc(sizeof(TIPO) * n);                                             \
+            buffer = malloc(sizeof(TIPO) * n);                                               \
+            capacidade = n;                                                                  \
+            if (!original || !buffer)                                                        \
+            {                                                                                \
+                fprintf(stderr, "Erro ao alocar buffer\n");                                  \
+                free(original);                                                              \
+                free(buffer);                                                                \
+                return 1;                                                                    \
+            }                                                                                \
+        }                                                                                    \
+        /* Elementos ilegíveis valem zero, como no modo int */                               \
+        for (int j = 0; j < n; j++)                                                          \
+            if (!LER(input, &original[j]))                                                   \
+                memset(&original[j], 0, sizeof(TIPO));                                       \
+                                                                                             \
+        for (int m = 0; m < metodos.qtd; m++)                                                \
+        {                                                                                    \
+            /* A chamada inicial conta como em quickSort */                                  \
+            Estatisticas stats = {0, 1, 0};                                                  \
+            if (n > 0)                                                                       \
+                memcpy(buffer, original, sizeof(TIPO) * n);                                  \
+            semearPivoAleatorio(sementePivos);                                               \
+            ordenadores[metodos.codigos[m] - 1](buffer, 0, n - 1, &stats);                   \
+            strcpy(resultados[m].nome, nomesMetodos[metodos.codigos[m] - 1]);                \
+            resultados[m].custo = stats.trocas + stats.chamadas;                             \
+        }                                                                                    \
+        insertionSort(resultados, metodos.qtd);                                              \
+        escreverResultados(output, resultados, metodos.qtd, n);                              \
+        fprintf(output, "\n");                                                               \
+    }                                                                                        \
+    free(original);                                                                          \
+    free(buffer);                                                                            \
+    return 1;                                                                                \
+}
+
+// Leitura de um elemento de cada tipo; registros vêm como chave:carga
+#define LER_INT64(arquivo, p) (fscanf(arquivo, "%" SCNd64, p) == 1)
+#define LER_UINT64(arquivo, p) (fscanf(arquivo, "%" SCNu64, p) == 1)
+#define LER_FLOAT(arquivo, p) (fscanf(arquivo, "%f", p) == 1)
+#define LER_DOUBLE(arquivo, p) (fscanf(arquivo, "%lf", p) == 1)
+#define LER_REGISTRO(arquivo, p) (fscanf(arquivo, "%" SCNu64 ":%" SCNu64, &(p)->chave, &(p)->carga) == 2)
+
+DEFINIR_PROCESSAMENTO_TIPO(quickSortInt64, int64_t, LER_INT64)
+DEFINIR_PROCESSAMENTO_TIPO(quickSortUint64, uint64_t, LER_UINT64)
+DEFINIR_PROCESSAMENTO_TIPO(quickSortFloat, float, LER_FLOAT)
+DEFINIR_PROCESSAMENTO_TIPO(quickSortDouble, double, LER_DOUBLE)
+DEFINIR_PROCESSAMENTO_TIPO(quickSortRegistro, RegistroChaveCarga, LER_REGISTRO)
+
+// Tipos de chave aceitos por --tipo além de int32 (o padrão)
+static const struct { const char *nome; int (*processar)(FILE *, FILE *, SelecaoMetodos); } tiposChave[] = {
+    {"int64", quickSortInt64Processar},
+    {"uint64", quickSortUint64Processar},
+    {"float", quickSortFloatProcessar},
+    {"double", quickSortDoubleProcessar},
+    {"registro", quickSortRegistroProcessar}
+};
+
+// Função geradora pseudoaleatória (splitmix64) com estado explícito
+uint64_t proximoAleatorio(uint64_t *estado)
+{
+    uint64_t z = (*estado += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// Procedimento de benchmark em arrays com poucos valores distintos: para cada
+// cardinalidade, gera um array de n elementos e mede trocas, chamadas, comparações
+// e tempo de cada método selecionado
+void benchmarkDuplicados(FILE *output, int n, SelecaoMetodos metodos)
+{
+    // Cardinalidades testadas (n = todos distintos, referência)
+    int cardinalidades[] = {1, 2, 4, 16, 256, 4096, n};
+    int qtdCard = sizeof(cardinalidades) / sizeof(cardinalidades[0]);
+    int *original = malloc(sizeof(int) * n);
+    int *buffer = malloc(sizeof(int) * n);
+    if (!original || !buffer)
+    {
+        fprintf(stderr, "Erro ao alocar buffer\n");
+        free(original);
+        free(buffer);
+        return;
+    }
+
+    fprintf(output, "Benchmark com %d elementos por array\n", n);
+    fprintf(output, "%12s %6s %14s %12s %14s %10s\n", "distintos", "metodo", "trocas", "chamadas", "comparacoes", "ms");
+    uint64_t semente = 42;
+    for (int c = 0; c < qtdCard; c++)
+    {
+        // Valores sorteados em [0, cardinalidade)
+        for (int i = 0; i < n; i++)
+            original[i] = (int)(proximoAleatorio(&semente) % (uint64_t)cardinalidades[c]);
+
+        for (int m = 0; m < metodos.qtd; m++)
+        {
+            Estatisticas stats = {0, 0, 0};
+            memcpy(buffer, original, sizeof(int) * n);
+            long long inicio = agoraNs();
+            quickSort(buffer, 0, n - 1, metodos.codigos[m], &stats);
+            double ms = (agoraNs() - inicio) / 1e6;
+            fprintf(output, "%12d %6s %14lld %12lld %14lld %10.2f\n", cardinalidades[c],
+                    nomesMetodos[metodos.codigos[m] - 1], stats.trocas, stats.chamadas, stats.comparacoes, ms);
+        }
+    }
+
+    free(original);
+    free(buffer);
+}
+
+// Estimador de custo (--estimar): os primeiros níveis da recursão são feitos sobre os
+// dados reais e cada faixa grande que sobra é extrapolada de amostras ordenadas
+#define NIVEIS_ESTIMATIVA 2
+// Tamanhos das amostras: AMOSTRA_MIN, o dobro, ... (TAMANHOS_AMOSTRA tamanhos)
+#define AMOSTRA_MIN 1024
+#define TAMANHOS_AMOSTRA 4
+// Faixas até este tamanho são ordenadas de verdade (custo exato)
+#define LIMIAR_ESTIMATIVA_EXATA (4 * (AMOSTRA_MIN << (TAMANHOS_AMOSTRA - 1)))
+// Réplicas independentes das amostras e o t de Student de 95% com REPLICAS - 1 graus
+#define REPLICAS_ESTIMATIVA 8
+#define T_STUDENT_95 2.365
+// Máximo de faixas estimadas: até três subfaixas por nível
+#define MAX_FOLHAS_ESTIMATIVA 9
+
+// Custo estimado de um método e meia largura do intervalo de 95% (0 quando exato)
+typedef struct
+{
+    double custo;
+    double margem;
+} Estimativa;
+
+// Procedimento que particiona [low, high] sobre os dados reais por até nivel níveis,
+// somando o custo exato em stats; as faixas pequenas são ordenadas de verdade e as
+// grandes que sobram vão para folhas
+void particionarNiveis(int *array, int low, int high, int method, int nivel, Estatisticas *stats,
+                       int folhas[][2], int *qtdFolhas)
+{
+    Subfaixas sub;
+    if (high - low + 1 <= LIMIAR_ESTIMATIVA_EXATA)
+        ordenarFaixa(array, low, high, method, stats);
+    else if (nivel > 0 && particionarFaixa(array, low, high, method, &sub, stats))
+    {
+        stats->chamadas += sub.qtd;
+        for (int f = 0; f < sub.qtd; f++)
+            particionarNiveis(array, sub.ini[f], sub.fim[f], method, nivel - 1, stats, folhas, qtdFolhas);
+    }
+    else
+    {
+        folhas[*qtdFolhas][0] = low;
+        folhas[*qtdFolhas][1] = high;
+        (*qtdFolhas)++;
+    }
+}
+
+// Procedimento que sorteia s elementos da faixa de m elementos, um por estrato e na
+// ordem original, para a amostra manter pré-ordenação, serras e duplicatas da faixa
+void amostrarFaixa(const int *array, int low, int m, int s, int *amostra, uint64_t *estado)
+{
+    for (int i = 0; i < s; i++)
+    {
+        long long ini = (long long)m * i / s, fim = (long long)m * (i + 1) / s;
+        amostra[i] = array[low + ini + (long long)(proximoAleatorio(estado) % (uint64_t)(fim - ini))];
+    }
+}
+
+// Função que extrapola para m elementos os custos das qtd primeiras amostras (tamanhos
+// AMOSTRA_MIN << j), ajustando custo / s = a * x + b por mínimos quadrados com peso s:
+// x = log2(s) (custo n log n) ou x = s (quadrático)
+double extrapolarCusto(const double *custos, int qtd, int quadratico, double m)
+{
+    double sw = 0, sx = 0, sy = 0, sxx = 0, sxy = 0;
+    for (int j = 0; j < qtd; j++)
+    {
+        double s = (double)(AMOSTRA_MIN << j);
+        double x = quadratico ? s : log2(s);
+        double y = custos[j] / s;
+        double w = (double)(1 << j);
+        sw += w;
+        sx += w * x;
+        sy += w * y;
+        sxx += w * x * x;
+        sxy += w * x * y;
+    }
+    double a = (sw * sxy - sx * sy) / (sw * sxx - sx * sx);
+    double b = (sy - a * sx) / sw;
+    double custo = m * (a * (quadratico ? m : log2(m)) + b);
+    return custo > 0 ? custo : 0;
+}
+
+// Função que escolhe o modelo pelo crescimento entre as duas maiores amostras (dobrar
+// a amostra mais que triplica o custo: quadrático) e devolve em erro o erro relativo
+// do modelo ao prever a maior amostra a partir das outras (o erro de uma dobra)
+int escolherModelo(const double *custos, double *erro)
+{
+    double maior = custos[TAMANHOS_AMOSTRA - 1] > 1 ? custos[TAMANHOS_AMOSTRA - 1] : 1;
+    int quadratico = custos[TAMANHOS_AMOSTRA - 1] > 3 * custos[TAMANHOS_AMOSTRA - 2];
+    double previsto = extrapolarCusto(custos, TAMANHOS_AMOSTRA - 1, quadratico, AMOSTRA_MIN << (TAMANHOS_AMOSTRA - 1));
+    *erro = fabs(previsto - custos[TAMANHOS_AMOSTRA - 1]) / maior;
+    return quadratico;
+}
+
+// Função que estima o custo (trocas + chamadas) do método sobre o array: os primeiros
+// níveis são exatos, numa cópia em buffer, e cada folha restante é extrapolada das
+// amostras. Cada réplica sorteia amostras novas e a média das réplicas é a estimativa
+// da folha. A variância da folha soma a das réplicas (dividida por REPLICAS, pois vale
+// a média) com a do modelo, que não cai com réplicas: o erro de uma dobra sobre as
+// amostras médias, ao quadrado, vezes as dobras até a folha (erros independentes por
+// dobra). As folhas são independentes, então as variâncias se somam e a margem é
+// t * sqrt(soma)
+Estimativa estimarCusto(Array original, int *buffer, int *amostra, int method, uint64_t *estado)
+{
+    if (original.size > 0)
+        memcpy(buffer, original.array, sizeof(int) * original.size);
+    // A chamada inicial conta como em quickSort
+    Estatisticas exato = {0, 1, 0};
+    int folhas[MAX_FOLHAS_ESTIMATIVA][2];
+    int qtdFolhas = 0;
+    semearPivoAleatorio(sementePivos);
+    particionarNiveis(buffer, 0, original.size - 1, method, NIVEIS_ESTIMATIVA, &exato, folhas, &qtdFolhas);
+
+    Estimativa e = {(double)(exato.trocas + exato.chamadas), 0};
+    double variancia = 0;
+    for (int f = 0; f < qtdFolhas; f++)
+    {
+        int m = folhas[f][1] - folhas[f][0] + 1;
+        double previstos[REPLICAS_ESTIMATIVA], media = 0, varianciaReplicas = 0;
+        double custosMedios[TAMANHOS_AMOSTRA] = {0}, erro;
+        for (int r = 0; r < REPLICAS_ESTIMATIVA; r++)
+        {
+            double custos[TAMANHOS_AMOSTRA];
+            for (int j = 0; j < TAMANHOS_AMOSTRA; j++)
+            {
+                // A amostra é uma faixa nova: custo sem a própria chamada, como a folha
+                Estatisticas stats = {0, 0, 0};
+                int s = AMOSTRA_MIN << j;
+                amostrarFaixa(buffer, folhas[f][0], m, s, amostra, estado);
+                ordenarFaixa(amostra, 0, s - 1, method, &stats);
+                custos[j] = (double)(stats.trocas + stats.chamadas);
+                custosMedios[j] += custos[j] / REPLICAS_ESTIMATIVA;
+            }
+            previstos[r] = extrapolarCusto(custos, TAMANHOS_AMOSTRA, escolherModelo(custos, &erro), m);
+            media += previstos[r] / REPLICAS_ESTIMATIVA;
+        }
+        for (int r = 0; r < REPLICAS_ESTIMATIVA; r++)
+            varianciaReplicas += (previstos[r] - media) * (previstos[r] - media) / (REPLICAS_ESTIMATIVA - 1);
+        escolherModelo(custosMedios, &erro);
+        double dobras = log2((double)m / (AMOSTRA_MIN << (TAMANHOS_AMOSTRA - 1)));
+        e.custo += media;
+        variancia += varianciaReplicas / REPLICAS_ESTIMATIVA + erro * media * erro * media * dobras;
+    }
+    e.margem = T_STUDENT_95 * sqrt(variancia);
+    return e;
+}
+
+// Função que diz se os intervalos de 95% de duas estimativas se sobrepõem: nesse caso
+// a ordem entre os dois métodos não é confiável
+int intervalosSobrepostos(Estimativa a, Estimativa b)
+{
+    return fabs(a.custo - b.custo) <= a.margem + b.margem;
+}
+
+// Procedimento do modo estimador: grava o ranking pelo custo estimado, com a meia
+// largura do intervalo de 95% de cada método, e se os intervalos dos dois primeiros se
+// sobrepõem. Com validar, também ordena cada array por completo e grava uma tabela de
+// estimativa contra custo exato, com os tempos, a cobertura dos intervalos e os arrays
+// em que o vencedor previsto acertou, separando os que tinham os dois primeiros sobrepostos
+void processarEstimativa(FILE *output, SetArrays dadosLidos, SelecaoMetodos metodos, int validar)
+{
+    int maxSize = 1;
+    for (int i = 0; i < dadosLidos.qtdArrays; i++)
+        if (dadosLidos.arrays[i].size > maxSize)
+            maxSize = dadosLidos.arrays[i].size;
+    int *buffer = malloc(sizeof(int) * maxSize);
+    int *amostra = malloc(sizeof(int) * (AMOSTRA_MIN << (TAMANHOS_AMOSTRA - 1)));
+    if (!buffer || !amostra)
+    {
+        fprintf(stderr, "Erro ao alocar buffer\n");
+        free(buffer);
+        free(amostra);
+        return;
+    }
+
+    if (validar)
+        fprintf(output, "%8s %12s %6s %16s %16s %14s %8s %6s %12s %12s\n", "array", "tamanho", "metodo", "exato",
+                "estimado", "margem_95", "erro_%", "dentro", "ms_exato", "ms_estimado");
+    int dentro = 0, acertos = 0, sobrepostos = 0, acertosSeparados = 0;
+    long long nsExato = 0, nsEstimativa = 0;
+    for (int i = 0; i < dadosLidos.qtdArrays; i++)
+    {
+        Array original = dadosLidos.arrays[i];
+        // Amostras reprodutíveis: a semente depende só de --semente e do array
+        uint64_t estado = sementePivos + (uint64_t)i;
+        MetodoResultado resultados[QTD_METODOS];
+        Estimativa estimativas[QTD_METODOS];
+        int melhorEstimado = 0, segundoEstimado = -1, melhorExato = 0;
+        long long exatos[QTD_METODOS];
+        for (int m = 0; m < metodos.qtd; m++)
+        {
+            int codigo = metodos.codigos[m];
+            long long inicio = agoraNs();
+            estimativas[m] = estimarCusto(original, buffer, amostra, codigo, &estado);
+            long long ns = agoraNs() - inicio;
+            nsEstimativa += ns;
+            strcpy(resultados[m].nome, nomesMetodos[codigo - 1]);
+            resultados[m].custo = llround(estimativas[m].custo);
+            if (m > 0 && estimativas[m].custo < estimativas[melhorEstimado].custo)
+            {
+                segundoEstimado = melhorEstimado;
+                melhorEstimado = m;
+            }
+            else if (m > 0 && (segundoEstimado < 0 || estimativas[m].custo < estimativas[segundoEstimado].custo))
+                segundoEstimado = m;
+            if (!validar)
+                continue;
+
+            // Custo exato da ordenação completa, como no modo normal
+            Estatisticas stats = {0, 0, 0};
+            if (original.size > 0)
+                memcpy(buffer, original.array, sizeof(int) * original.size);
+            long long inicioExato = agoraNs();
+            quickSort(buffer, 0, original.size - 1, codigo, &stats);
+            long long nsOrdenacao = agoraNs() - inicioExato;
+            nsExato += nsOrdenacao;
+            exatos[m] = stats.trocas + stats.chamadas;
+            if (exatos[m] < exatos[melhorExato])
+                melhorExato = m;
+            double erro = exatos[m] ? 100.0 * (estimativas[m].custo - exatos[m]) / exatos[m] : 0;
+            int cobre = fabs(estimativas[m].custo - exatos[m]) <= estimativas[m].margem + 0.5;
+            dentro += cobre;
+            fprintf(output, "%8d %12d %6s %16lld %16lld %14lld %8.2f %6s %12.2f %12.2f\n", i, original.size,
+                    resultados[m].nome, exatos[m], resultados[m].custo, llround(estimativas[m].margem), erro,
+                    cobre ? "sim" : "nao", nsOrdenacao / 1e6, ns / 1e6);
+        }
+
+        // Com um só método não há ordem a duvidar
+        int sobreposto = segundoEstimado >= 0 &&
+                         intervalosSobrepostos(estimativas[melhorEstimado], estimativas[segundoEstimado]);
+        if (validar)
+        {
+            sobrepostos += sobreposto;
+            acertos += melhorEstimado == melhorExato;
+            acertosSeparados += !sobreposto && melhorEstimado == melhorExato;
+            continue;
+        }
+        // Ranking estimado; a margem acompanha o método pelo nome
+        insertionSort(resultados, metodos.qtd);
+        fprintf(output, "[%d]:", original.size);
+        for (int r = 0; r < metodos.qtd; r++)
+        {
+            double margem = 0;
+            for (int m = 0; m < metodos.qtd; m++)
+                if (strcmp(nomesMetodos[metodos.codigos[m] - 1], resultados[r].nome) == 0)
+                    margem = estimativas[m].margem;
+            fprintf(output, "%s(%lld±%lld)%s", resultados[r].nome, resultados[r].custo, llround(margem),
+                    r < metodos.qtd - 1 ? "," : "");
+        }
+        fprintf(output, "%s\n", sobreposto ? " 1º e 2º sobrepostos" : "");
+    }
+
+    if (validar)
+    {
+        fprintf(output, "Intervalos que contêm o custo exato: %d de %d\n", dentro, dadosLidos.qtdArrays * metodos.qtd);
+        fprintf(output, "Arrays com o vencedor previsto correto: %d de %d\n", acertos, dadosLidos.qtdArrays);
+        fprintf(output, "Arrays com os intervalos dos dois primeiros sobrepostos: %d; vencedor correto nos demais: %d de %d\n",
+                sobrepostos, acertosSeparados, dadosLidos.qtdArrays - sobrepostos);
+        fprintf(output, "Tempo: estimativa %.2f ms, ordenação completa %.2f ms\n", nsEstimativa / 1e6, nsExato / 1e6);
+    }
+    free(buffer);
+    free(amostra);
+}
+
+// Função que lê a lista de métodos ("LP,HM,BA" ou "todos"); retorna 0 se inválida
+int lerMetodos(const char *lista, SelecaoMetodos *sel)
+{
+    sel->qtd = 0;
+    sel->todos = strcmp(lista, "todos") == 0;
+    // Todos os métodos na ordem dos códigos
+    if (sel->todos)
+    {
+        for (int c = 1; c <= QTD_METODOS; c++)
+            sel->codigos[sel->qtd++] = c;
+        return 1;
+    }
+
+    while (*lista)
+    {
+        // Procura o nome de dois caracteres na tabela de métodos
+        int codigo = 0;
+        for (int c = 0; c < QTD_METODOS; c++)
+            if (strncmp(lista, nomesMetodos[c], 2) == 0)
+                codigo = c + 1;
+        // Rejeita nomes desconhecidos, repetidos ou mal separados
+        if (!codigo || (lista[2] != ',' && lista[2] != '\0'))
+            return 0;
+        for (int m = 0; m < sel->qtd; m++)
+            if (sel->codigos[m] == codigo)
+                return 0;
+        sel->codigos[sel->qtd++] = codigo;
+        lista += lista[2] == ',' ? 3 : 2;
+    }
+    return sel->qtd > 0;
+}
+
+// Função que lê as opções opcionais após os arquivos
+int lerOpcoes(int argc, char *argv[], Configuracao *cfg)
+{
+    for (int a = 3; a < argc; a++)
+    {
+        const char *opcao = argv[a];
+        if (strncmp(opcao, "--threads=", 10) == 0 && atoi(opcao + 10) > 0) cfg->threads = atoi(opcao + 10);
+        else if (strncmp(opcao, "--metodos=", 10) == 0 && lerMetodos(opcao + 10, &cfg->metodos)) continue;
+        else if (strncmp(opcao, "--metricas-csv=", 15) == 0 && opcao[15]) cfg->metricasCsv = opcao + 15;
+        else if (strncmp(opcao, "--metricas-json=", 16) == 0 && opcao[16]) cfg->metricasJson = opcao + 16;
+        else if (strcmp(opcao, "--paralelo") == 0) cfg->paralelo = 1;
+        else if (strcmp(opcao, "--streaming") == 0) cfg->streaming = 1;
+        else if (strcmp(opcao, "--estimar") == 0) cfg->estimar = 1;
+        else if (strcmp(opcao, "--estimar=validar") == 0) cfg->estimar = 2;
+        else if (strncmp(opcao, "--externo=", 10) == 0 && atoll(opcao + 10) > 0) cfg->memoriaExterna = (size_t)atoll(opcao + 10) << 20;
+        else if (strncmp(opcao, "--ordenado=", 11) == 0 && opcao[11]) cfg->ordenado = opcao + 11;
+        else if (strncmp(opcao, "--temp=", 7) == 0 && opcao[7]) cfg->pastaTemporaria = opcao + 7;
+        else if (strncmp(opcao, "--semente=", 10) == 0 && opcao[10]) sementePivos = strtoull(opcao + 10, NULL, 10);
+        else if (strncmp(opcao, "--kernel=", 9) == 0 && opcao[9]) cfg->kernel = opcao + 9;
+        else if (strncmp(opcao, "--tipo=", 7) == 0 && opcao[7]) cfg->tipo = strcmp(opcao + 7, "int32") ? opcao + 7 : NULL;
+        else if (strcmp(opcao, "--converter=binario") == 0 || strcmp(opcao, "--converter=texto") == 0) cfg->converter = opcao + 12;
+        else if (strncmp(opcao, "--bench-duplicados=", 19) == 0 && atoi(opcao + 19) > 0) cfg->benchDuplicados = atoi(opcao + 19);
+        else
+        {
+            printf("Opção inválida: %s\n", opcao);
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// Procedimento para liberar memória
+void liberarSetArrays(SetArrays *set)
+{
+    // Verifica se o set é válido
+    if (set && set->arrays)
+    {
+        // Libera cada array individualmente (ou o mapa da entrada binária)
+        if (set->mapa)
+            munmap(set->mapa, set->tamanhoMapa);
+        else
+            for (int i = 0; i < set->qtdArrays; ++i)
+                if (set->arrays[i].array)
+                    free(set->arrays[i].array);
         // Libera o array de arrays
         free(set->arrays);
         // Zera os campos
         set->arrays = NULL;
         set->qtdArrays = 0;
+        set->mapa = NULL;
     }
 }
 
 int main(int argc, char *argv[])
 {
     // Verifica argumentos
-    if (argc != 3)
+    if (argc < 3)
+    {
+        printf("Uso: %s <arquivo_entrada> <arquivo_saida> [opções]\n", argv[0]);
+        printf("Opções: --threads=N (pares array/método avaliados em paralelo; padrão: um por núcleo)\n");
+        printf("        --metodos=LP,LM,LA,HP,HM,HA,BM,BA,TV,DP,VM,PD|todos (métodos do ranking; padrão: os seis de Lomuto/Hoare)\n");
+        printf("        e as combinações esquema L/H/B/T/D (duplo pivô) + pivô R (aleatório), N (ninther),\n");
+        printf("        S (amostra sqrt(n)), D (mediana exata, BFPRT), como HR, LN, BS, DD (PD e VM sem variantes)\n");
+        printf("        --semente=N (semente dos pivôs aleatórios R, reaplicada a cada ordenação e, com --paralelo,\n");
+        printf("        combinada com os limites de cada faixa; padrão: 42)\n");
+        printf("        --metricas-csv=arquivo --metricas-json=arquivo (tempo, comparações e contadores\n");
+        printf("        de hardware por método e pico de memória do processo; use --threads=1 para\n");
+        printf("        medições sem concorrência)\n");
+        printf("        --paralelo (cada array é ordenado pelas N threads, com roubo de trabalho)\n");
+        printf("        --streaming (lê, avalia e descarta um array por vez, lendo o próximo durante a avaliação;\n");
+        printf("        memória em torno de (2 + B) vezes o maior array no texto e (1 + B) no binário, com\n");
+        printf("        B = min(N, métodos) buffers de avaliação, ou B = 2 com --paralelo)\n");
+        printf("        --externo=MB (entrada binária maior que a memória: cada array é avaliado em corridas de\n");
+        printf("        até MB megabytes, com custos e métricas somados entre as corridas)\n");
+        printf("        --ordenado=arquivo (com --externo, grava os arrays ordenados em binário, intercalando as\n");
+        printf("        corridas com árvore de perdedores) --temp=pasta (temporários; padrão: $TMPDIR ou /tmp)\n");
+        printf("        --estimar (ranking pelo custo estimado: %d níveis da recursão sobre os dados e o resto\n",
+               NIVEIS_ESTIMATIVA);
+        printf("        extrapolado de amostras, com intervalo de 95%%, como HM(123±4), e \"1º e 2º sobrepostos\"\n");
+        printf("        quando a ordem dos dois primeiros não é confiável; --estimar=validar grava estimativa e\n");
+        printf("        custo exato de cada método, com os tempos e a cobertura dos intervalos)\n");
+        printf("        --kernel=avx512|avx2|escalar (partição do método VM; padrão: o melhor segundo o CPUID;\n");
+        printf("        os vetoriais gravam as chaves por compressão e contam uma troca por par de chaves\n");
+        printf("        fora de lugar; o arranjo e o custo do VM variam entre kernels)\n");
+        printf("        --tipo=int32|int64|uint64|float|double|registro (tipo das chaves; registros como\n");
+        printf("        chave:carga; fora de int32 a avaliação é serial, sem VM (todos = todos menos o VM),\n");
+        printf("        métricas nem --paralelo; em float e double os NaN são ordenados depois dos números)\n");
+        printf("        --converter=binario|texto (grava a entrada no outro formato em <arquivo_saida>; a entrada\n");
+        printf("        binária, detectada pela assinatura, é usada sem cópia e sem conversão de texto)\n");
+        printf("        --bench-duplicados=N (arrays gerados com poucos valores distintos; a entrada é ignorada\n");
+        printf("        e o relatório vai para <arquivo_saida>; padrão: todos os métodos)\n");
+        return 1;
+    }
+
+    // Configuração padrão: uma thread por núcleo; sem --metodos, o ranking usa
+    // os seis métodos originais (LP, LM, LA, HP, HM, HA) e o benchmark usa todos
+    Configuracao cfg = {(int)sysconf(_SC_NPROCESSORS_ONLN), {{0}, 0, 0}, NULL, NULL, 0, 0, NULL, NULL, NULL, 0, 0, NULL, NULL, 0};
+    if (cfg.threads < 1) cfg.threads = 1;
+    if (!lerOpcoes(argc, argv, &cfg)) return 1;
+    if (cfg.metodos.qtd == 0)
+        lerMetodos(cfg.benchDuplicados ? "todos" : "LP,LM,LA,HP,HM,HA", &cfg.metodos);
+    // Kernel do método VM (antes de criar as threads)
+    if (!selecionarKernel(cfg.kernel))
+    {
+        printf("Kernel não suportado neste processador: %s\n", cfg.kernel);
+        return 1;
+    }
+
+    // Tipo das chaves: fora de int32 não há método VM, métricas nem modo paralelo;
+    // "todos" passa a ser todos menos o VM e só o VM pedido pelo nome é rejeitado
+    int tipoChave = -1;
+    if (cfg.tipo)
+    {
+        for (int t = 0; t < (int)(sizeof(tiposChave) / sizeof(tiposChave[0])); t++)
+            if (strcmp(cfg.tipo, tiposChave[t].nome) == 0)
+                tipoChave = t;
+        int temVetorial = 0, qtd = 0;
+        for (int m = 0; m < cfg.metodos.qtd; m++)
+        {
+            if (cfg.metodos.codigos[m] != 11)
+                cfg.metodos.codigos[qtd++] = cfg.metodos.codigos[m];
+            else if (!cfg.metodos.todos)
+                temVetorial = 1;
+        }
+        cfg.metodos.qtd = qtd;
+        if (tipoChave < 0 || temVetorial || cfg.metricasCsv || cfg.metricasJson || cfg.paralelo || cfg.benchDuplicados ||
+            cfg.converter || cfg.streaming || cfg.memoriaExterna || cfg.estimar)
+        {
+            printf("Tipo inválido ou incompatível com as opções: %s\n", cfg.tipo);
+            return 1;
+        }
+    }
+
+    // Modo externo: sem streaming, conversão nem benchmark
+    if ((!cfg.memoriaExterna && (cfg.ordenado || cfg.pastaTemporaria)) ||
+        (cfg.memoriaExterna && (cfg.streaming || cfg.converter || cfg.benchDuplicados)))
+    {
+        printf("--ordenado e --temp exigem --externo, que não combina com --streaming, --converter nem --bench-duplicados\n");
+        return 1;
+    }
+
+    // Modo estimador: só o ranking, serial e sobre a entrada inteira na memória
+    if (cfg.estimar && (cfg.metricasCsv || cfg.metricasJson || cfg.paralelo || cfg.streaming || cfg.converter ||
+                        cfg.benchDuplicados || cfg.memoriaExterna))
     {
-        printf("Uso: %s <arquivo_entrada> <arquivo_saida>\n", argv[0]);
+        printf("--estimar não combina com métricas, --paralelo, --streaming, --converter, --bench-duplicados nem --externo\n");
         return 1;
     }
 
-    // Abre arquivos
-    FILE* input = fopen(argv[1], "r");
-    FILE* output = fopen(argv[2], "w");
-    if (!input || !output) {
+    // Modo benchmark: não lê a entrada
+    if (cfg.benchDuplicados)
+    {
+        FILE* output = fopen(argv[2], "w");
+        if (!output)
+        {
+            printf("Erro ao abrir arquivos.\n");
+            return 1;
+        }
+        benchmarkDuplicados(output, cfg.benchDuplicados, cfg.metodos);
+        fclose(output);
+        return 0;
+    }
+
+    // Chaves de outro tipo: lê e avalia um array por vez
+    if (tipoChave >= 0)
+    {
+        FILE* input = fopen(argv[1], "r");
+        FILE* output = fopen(argv[2], "w");
+        if (!input || !output)
+        {
+            printf("Erro ao abrir arquivos.\n");
+            return 1;
+        }
+        int ok = tiposChave[tipoChave].processar(input, output, cfg.metodos);
+        if (!ok)
+            printf("Nenhum array válido encontrado no arquivo.\n");
+        fclose(input);
+        fclose(output);
+        return ok ? 0 : 1;
+    }
+
+    // Abre arquivos; a entrada é mapeada em memória
+    Entrada input;
+    int abriu = abrirEntrada(argv[1], &input);
+    FILE* output = fopen(argv[2], cfg.converter ? "wb" : "w");
+    // Arquivos de métricas do modo instrumentado (opcionais)
+    FILE* csv = cfg.metricasCsv ? fopen(cfg.metricasCsv, "w") : NULL;
+    FILE* json = cfg.metricasJson ? fopen(cfg.metricasJson, "w") : NULL;
+    if (!abriu || !output || (cfg.metricasCsv && !csv) || (cfg.metricasJson && !json)) {
         printf("Erro ao abrir arquivos.\n");
         return 1;
     }
+    // Cabeçalho do CSV e início da lista JSON, seguidos das métricas de cada array
+    if (csv) escreverCabecalhoCsv(csv);
+    if (json) fprintf(json, "[");
 
-    // Lê dados do arquivo de entrada
-    SetArrays dadosLidos = lerDados(input);
+    // Modo streaming: lê e avalia um array por vez
+    if (cfg.streaming && !cfg.converter)
+    {
+        int ok = processarStreaming(&input, output, cfg.metodos, cfg.threads, cfg.paralelo, csv, json);
+        if (ok < 0)
+            printf("Nenhum array válido encontrado no arquivo.\n");
+        if (json) fprintf(json, "\n]\n");
+        fecharEntrada(&input);
+        fclose(output);
+        if (csv) fclose(csv);
+        if (json) fclose(json);
+        return ok == 1 ? 0 : 1;
+    }
+
+    // Modo externo: a entrada binária é lida em corridas, sem carregá-la inteira
+    if (cfg.memoriaExterna)
+    {
+        int ok = processarExterno(&input, argv[1], output, cfg.metodos, cfg.threads, cfg.paralelo, cfg.memoriaExterna,
+                                  cfg.ordenado, cfg.pastaTemporaria, csv, json);
+        if (json) fprintf(json, "\n]\n");
+        fecharEntrada(&input);
+        fclose(output);
+        if (csv) fclose(csv);
+        if (json) fclose(json);
+        return ok == 1 ? 0 : 1;
+    }
+
+    // Lê dados do arquivo de entrada; o texto já foi copiado para os arrays e o
+    // mapa da entrada binária passou para dadosLidos, então a entrada é fechada
+    SetArrays dadosLidos = lerDados(&input);
+    fecharEntrada(&input);
     if (dadosLidos.qtdArrays == 0)
     {
         printf("Nenhum array válido encontrado no arquivo.\n");
-        fclose(input);
         fclose(output);
         return 1;
     }
 
-    // Nomes dos métodos na ordem dos casos (1-6)
-    char nomesMetodos[6][3] = {"LP", "LM", "LA", "HP", "HM", "HA"};
-    // Processar cada array
-    processarDados(output, dadosLidos, nomesMetodos);
+    // Conversão entre os formatos de entrada, sem avaliação
+    if (cfg.converter)
+    {
+        int ok = strcmp(cfg.converter, "binario") == 0 ? escreverBinario(output, &dadosLidos)
+                                                       : escreverTexto(output, &dadosLidos);
+        if (!ok)
+            printf("Erro ao gravar o arquivo convertido.\n");
+        liberarSetArrays(&dadosLidos);
+        fclose(output);
+        return ok ? 0 : 1;
+    }
+
+    // Processar cada array (custos estimados ou exatos)
+    if (cfg.estimar)
+        processarEstimativa(output, dadosLidos, cfg.metodos, cfg.estimar == 2);
+    else
+        processarDados(output, dadosLidos, 0, cfg.metodos, cfg.threads, cfg.paralelo, csv, json, NULL);
+    if (json) fprintf(json, "\n]\n");
     // Libera memória
     liberarSetArrays(&dadosLidos);
     // Fecha arquivos
-    fclose(input);
     fclose(output);
+    if (csv) fclose(csv);
+    if (json) fclose(json);
 
     return 0;
 }
\ No newline at end of file
@@ -9,6 +9,14 @@ typedef struct Pacote
     unsigned char dados[512];
 } Pacote;
 
+// Chave de ordenação de um pacote: a prioridade e o índice do pacote na entrada
+// (8 bytes); o heap move só as chaves e os dados ficam no lugar até a saída
+typedef struct
+{
+    int prioridade;
+    int indice;
+} ChavePacote;
+
 typedef struct
 {
     int numPacotes; 
@@ -77,7 +85,7 @@ Entrada *lerDados(FILE *entrada)
 }
 
 // Procedimento para construir o heap
-void heapify(Pacote *heap, int n, int i)
+void heapify(ChavePacote *heap, int n, int i)
 {
     // Inicializa o maior como raiz
     int raiz = i;
@@ -97,7 +105,7 @@ void heapify(Pacote *heap, int n, int i)
     if (raiz != i)
     {
         // Troca heap[i] com heap[raiz]
-        Pacote tmp = heap[i];
+        ChavePacote tmp = heap[i];
         // Realiza a troca
         heap[i] = heap[raiz];
         // Completa a troca
@@ -108,7 +116,7 @@ void heapify(Pacote *heap, int n, int i)
 }
 
 // Procedimento para construir o heap inicial
-void construirHeap(Pacote *heap, int n)
+void construirHeap(ChavePacote *heap, int n)
 {
     // Constrói o heap (reorganiza o array)
     for (int i = (n/2) - 1; i >= 0; i--)
@@ -116,7 +124,7 @@ void construirHeap(Pacote *heap, int n)
 }
 
 // Procedimento para realizar o Heap Sort
-void heapSort(Pacote *vetor, int n)
+void heapSort(ChavePacote *vetor, int n)
 {
     // Constrói o heap inicial
     construirHeap(vetor, n);
@@ -125,7 +133,7 @@ void heapSort(Pacote *vetor, int n)
     for (int i = n - 1; i > 0; i--)
     {
         // Move a raiz atual para o final
-        Pacote tmp = vetor[0];
+        ChavePacote tmp = vetor[0];
         // Move o maior valor para o final
         vetor[0] = vetor[i];
         // Coloca o valor da raiz no final
@@ -135,10 +143,10 @@ void heapSort(Pacote *vetor, int n)
     }
 }
 
-// Procedimento para processar o buffer de pacotes
-void processarBuffer(FILE *output, Pacote *buffer, int qtd)
+// Procedimento para processar o buffer de chaves dos pacotes do lote
+void processarBuffer(FILE *output, const Pacote *pacotes, ChavePacote *buffer, int qtd)
 {
-    // Ordena o lote inteiro
+    // Ordena as chaves do lote inteiro
     heapSort(buffer, qtd);
     // Percorre o vetor ordenado
     fprintf(output, "|");
@@ -146,14 +154,14 @@ void processarBuffer(FILE *output, Pacote *buffer, int qtd)
     // Imprime os pacotes no formato especificado
     for (int i = 0; i < qtd; i++)
     {
-        // Obtém o pacote atual
-        Pacote p = buffer[i];
+        // Obtém o pacote atual pelo índice da chave
+        const Pacote *p = &pacotes[buffer[i].indice];
 
         // Imprime os dados do pacote em formato hexadecimal
-        for (int j = 0; j < p.tamanho; j++)
+        for (int j = 0; j < p->tamanho; j++)
         {
-            fprintf(output, "%02X", p.dados[j]);
-            if (j + 1 < p.tamanho)
+            fprintf(output, "%02X", p->dados[j]);
+            if (j + 1 < p->tamanho)
                 fprintf(output, ",");
         }
         fprintf(output, "|");
@@ -165,8 +173,8 @@ void processarBuffer(FILE *output, Pacote *buffer, int qtd)
 // Procedimento para processar os pacotes conforme a capacidade do roteador
 void processarPacotes(Entrada *dados, FILE *output)
 {
-    // Aloca o buffer para armazenar os pacotes temporariamente
-    Pacote *buffer = malloc(dados->numPacotes * sizeof(Pacote));
+    // Aloca o buffer para armazenar as chaves dos pacotes temporariamente
+    ChavePacote *buffer = malloc(dados->numPacotes * sizeof(ChavePacote));
     if (!buffer)
     {
         perror("Erro de alocação do buffer");
@@ -188,20 +196,22 @@ void processarPacotes(Entrada *dados, FILE *output)
         if (p->tamanho > capacidadeRestante && qtdBuffer > 0)
         {
             // Processa o buffer atual
-            processarBuffer(output, buffer, qtdBuffer);
+            processarBuffer(output, dados->pacotes, buffer, qtdBuffer);
             // Reinicia o buffer
             qtdBuffer = 0;
             capacidadeRestante = dados->capacidade;
         }
 
-        // Agora ele necessariamente cabe
-        buffer[qtdBuffer++] = *p;
+        // Agora ele necessariamente cabe; só a chave entra no buffer
+        buffer[qtdBuffer].prioridade = p->prioridade;
+        buffer[qtdBuffer].indice = i;
+        qtdBuffer++;
         capacidadeRestante -= p->tamanho;
     }
 
     // Se restou algo no buffer, processa
     if (qtdBuffer > 0)
-        processarBuffer(output, buffer, qtdBuffer);
+        processarBuffer(output, dados->pacotes, buffer, qtdBuffer);
 
     // Libera o buffer
     free(buffer);
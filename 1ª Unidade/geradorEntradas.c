@@ -0,0 +1,448 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+#include "quickSortGenerico.h"
+
+// Distribuições de entrada disponíveis (na ordem dos nomes)
+enum { DIST_UNIFORME, DIST_ORDENADO, DIST_REVERSO, DIST_ORGAO, DIST_SERRA, DIST_POUCOS, DIST_ZIPF, DIST_ANTIQSORT,
+       QTD_DISTRIBUICOES };
+static const char *nomesDistribuicoes[QTD_DISTRIBUICOES] = {"uniforme", "ordenado", "reverso", "orgao",
+                                                            "serra", "poucos", "zipf", "antiqsort"};
+
+// Formato binário de evertonlucas_202400017737_quicksort.c: cabeçalho, tamanhos dos
+// arrays (int32) e, a partir de offDados (alinhado em 8), os elementos; little-endian
+#define MAGICA_BINARIO "QUICKBIN"
+#define VERSAO_BINARIO 1
+
+typedef struct
+{
+    char magica[8];
+    uint32_t versao;
+    uint32_t qtdArrays;
+    uint64_t offDados;
+    uint64_t tamanho;
+} CabecalhoBinario;
+
+// Configuração da geração (argumentos e opções de linha de comando)
+typedef struct
+{
+    int distribuicao;
+    int tamanho;
+    int qtdArrays;
+    uint64_t semente;
+    int binario;
+    // Valores distintos de poucos e zipf, altura dos dentes de serra (0 = padrão)
+    int distintos;
+    // Expoente s da lei de Zipf (frequência do k-ésimo valor proporcional a 1/k^s)
+    double expoente;
+    // Método de evertonlucas_202400017737_quicksort.c atacado pelo antiqsort
+    const char *vitima;
+    // Semente dos pivôs R da vítima (a mesma do --semente do quicksort)
+    uint64_t sementePivos;
+} Configuracao;
+
+// Gerador PCG32 (XSH RR) com estado próprio, independente do gerador dos pivôs
+typedef struct
+{
+    uint64_t estado;
+} Pcg32;
+
+// Procedimento que inicia o gerador a partir da semente
+void semearPcg(Pcg32 *g, uint64_t semente)
+{
+    g->estado = (semente + 1442695040888963407ULL) * 6364136223846793005ULL + 1442695040888963407ULL;
+}
+
+// Função que sorteia 32 bits
+uint32_t proximoPcg(Pcg32 *g)
+{
+    uint64_t x = g->estado;
+    g->estado = x * 6364136223846793005ULL + 1442695040888963407ULL;
+    uint32_t misturado = (uint32_t)(((x >> 18) ^ x) >> 27);
+    uint32_t rotacao = (uint32_t)(x >> 59);
+    return (misturado >> rotacao) | (misturado << ((32 - rotacao) & 31));
+}
+
+// Função que sorteia um inteiro em [0, limite) por multiplicação (viés < limite / 2^32)
+uint32_t proximoLimitado(Pcg32 *g, uint32_t limite)
+{
+    return (uint32_t)(((uint64_t)proximoPcg(g) * limite) >> 32);
+}
+
+// Função que sorteia um real em [0, 1) com 53 bits
+double proximoReal(Pcg32 *g)
+{
+    uint64_t bits = ((uint64_t)proximoPcg(g) << 21) ^ (proximoPcg(g) >> 11);
+    return (double)(bits & ((1ULL << 53) - 1)) / (double)(1ULL << 53);
+}
+
+// Saída com buffer próprio: os elementos são formatados e gravados em blocos,
+// sem guardar o array inteiro na memória
+#define TAM_BUFFER_SAIDA (1 << 20)
+
+typedef struct
+{
+    FILE *arquivo;
+    int binario;
+    char *buffer;
+    size_t usado;
+} Saida;
+
+// Procedimento que grava o conteúdo do buffer no arquivo
+void descarregarSaida(Saida *s)
+{
+    if (s->usado)
+        fwrite(s->buffer, 1, s->usado, s->arquivo);
+    s->usado = 0;
+}
+
+// Procedimento que acrescenta um elemento à saída; no texto, separador é o
+// espaço entre elementos (o fim da linha é escrito por terminarArrayTexto)
+void emitirValor(Saida *s, int32_t valor, int primeiro)
+{
+    // Espaço para o maior elemento formatado
+    if (s->usado + 16 > TAM_BUFFER_SAIDA)
+        descarregarSaida(s);
+    if (s->binario)
+    {
+        memcpy(s->buffer + s->usado, &valor, sizeof(valor));
+        s->usado += sizeof(valor);
+        return;
+    }
+    if (!primeiro)
+        s->buffer[s->usado++] = ' ';
+    // Dígitos em ordem inversa num buffer local (magnitude em 64 bits: sem estouro em INT32_MIN)
+    char digitos[12];
+    int qtd = 0;
+    int64_t magnitude = valor < 0 ? -(int64_t)valor : valor;
+    do
+    {
+        digitos[qtd++] = (char)('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude);
+    if (valor < 0)
+        s->buffer[s->usado++] = '-';
+    while (qtd)
+        s->buffer[s->usado++] = digitos[--qtd];
+}
+
+// Procedimento que escreve o cabeçalho do formato escolhido (todos os arrays têm o mesmo tamanho)
+void escreverCabecalho(Saida *s, int qtdArrays, int tamanho)
+{
+    if (!s->binario)
+    {
+        fprintf(s->arquivo, "%d\n", qtdArrays);
+        return;
+    }
+    static const char zeros[8] = {0};
+    CabecalhoBinario cab;
+    memset(&cab, 0, sizeof(cab));
+    memcpy(cab.magica, MAGICA_BINARIO, 8);
+    cab.versao = VERSAO_BINARIO;
+    cab.qtdArrays = (uint32_t)qtdArrays;
+    uint64_t fimTamanhos = sizeof(CabecalhoBinario) + (uint64_t)qtdArrays * sizeof(int32_t);
+    cab.offDados = (fimTamanhos + 7) & ~(uint64_t)7;
+    cab.tamanho = cab.offDados + (uint64_t)qtdArrays * (uint64_t)tamanho * sizeof(int32_t);
+    fwrite(&cab, sizeof(cab), 1, s->arquivo);
+    int32_t tamanho32 = tamanho;
+    for (int i = 0; i < qtdArrays; i++)
+        fwrite(&tamanho32, sizeof(tamanho32), 1, s->arquivo);
+    fwrite(zeros, 1, (size_t)(cab.offDados - fimTamanhos), s->arquivo);
+}
+
+// Procedimento que abre um array no texto (linha com o tamanho)
+void iniciarArrayTexto(Saida *s, int tamanho)
+{
+    if (s->binario)
+        return;
+    descarregarSaida(s);
+    fprintf(s->arquivo, "%d\n", tamanho);
+}
+
+// Procedimento que fecha a linha dos elementos no texto
+void terminarArrayTexto(Saida *s)
+{
+    if (s->binario)
+        return;
+    descarregarSaida(s);
+    fputc('\n', s->arquivo);
+}
+
+// Adversário de McIlroy ("A Killer Adversary for Quicksort"): os elementos
+// ordenados são índices em valoresAdversario, todos começando como "gás" (maior
+// que qualquer valor fixado). Quando dois gases são comparados, um deles é
+// congelado com o próximo valor sólido, preferindo o que não é o candidato a
+// pivô; assim o pivô tende a ser sempre o menor dos restantes. Ao final, os
+// valores formam uma entrada que leva a vítima ao seu pior caso
+static int *valoresAdversario;
+static int gasAdversario, solidosAdversario, candidatoAdversario;
+
+// Função de comparação do adversário (<0, 0, >0 como em qsort)
+static inline int compararAdversario(int x, int y)
+{
+    if (valoresAdversario[x] == gasAdversario && valoresAdversario[y] == gasAdversario)
+        valoresAdversario[x == candidatoAdversario ? x : y] = solidosAdversario++;
+    if (valoresAdversario[x] == gasAdversario)
+        candidatoAdversario = x;
+    else if (valoresAdversario[y] == gasAdversario)
+        candidatoAdversario = y;
+    return (valoresAdversario[x] > valoresAdversario[y]) - (valoresAdversario[x] < valoresAdversario[y]);
+}
+
+// A vítima são os mesmos quick sorts do programa principal, especializados para
+// os índices do adversário; SEMENTE usa o índice porque o valor ainda não existe,
+// então a política A (semente tirada do elemento) não é atacada com exatidão
+#define MENOR_ADVERSARIO(a, b) (compararAdversario((a), (b)) < 0)
+#define SEMENTE_INDICE(x) ((unsigned long long)(x))
+DEFINIR_QUICKSORT(adversario, int, MENOR_ADVERSARIO, SEMENTE_INDICE)
+
+// Métodos que podem ser atacados (VM compara direto em SIMD, sem o comparador)
+typedef struct
+{
+    const char *nome;
+    void (*ordenar)(int *, int, int, Estatisticas *);
+} Vitima;
+
+static const Vitima vitimas[] = {
+    {"LP", adversarioLP}, {"LM", adversarioLM}, {"LA", adversarioLA}, {"HP", adversarioHP}, {"HM", adversarioHM},
+    {"HA", adversarioHA}, {"BM", adversarioBM}, {"BA", adversarioBA}, {"TV", adversarioTV}, {"DP", adversarioDP},
+    {"PD", adversarioPD}, {"LR", adversarioLR}, {"LN", adversarioLN}, {"LS", adversarioLS}, {"LD", adversarioLD},
+    {"HR", adversarioHR}, {"HN", adversarioHN}, {"HS", adversarioHS}, {"HD", adversarioHD}, {"BR", adversarioBR},
+    {"BN", adversarioBN}, {"BS", adversarioBS}, {"BD", adversarioBD}, {"TR", adversarioTR}, {"TN", adversarioTN},
+    {"TS", adversarioTS}, {"TD", adversarioTD}, {"DR", adversarioDR}, {"DN", adversarioDN}, {"DS", adversarioDS},
+    {"DD", adversarioDD}};
+
+// Função que monta a entrada adversária de n elementos contra o método; devolve
+// NULL se o método não existe ou falta memória. Custa o mesmo que a ordenação
+// atacada: quadrático quando o ataque funciona
+int *gerarAntiqsort(int n, const char *vitima, uint64_t sementePivos, long long *comparacoes)
+{
+    const Vitima *v = NULL;
+    for (size_t i = 0; i < sizeof(vitimas) / sizeof(vitimas[0]); i++)
+        if (strcmp(vitimas[i].nome, vitima) == 0)
+            v = &vitimas[i];
+    if (!v)
+    {
+        fprintf(stderr, "Método sem ataque: %s\n", vitima);
+        return NULL;
+    }
+
+    int *valores = malloc(sizeof(int) * (size_t)(n > 0 ? n : 1));
+    int *indices = malloc(sizeof(int) * (size_t)(n > 0 ? n : 1));
+    if (!valores || !indices)
+    {
+        fprintf(stderr, "Erro ao alocar o adversário\n");
+        free(valores);
+        free(indices);
+        return NULL;
+    }
+    for (int i = 0; i < n; i++)
+    {
+        valores[i] = n;
+        indices[i] = i;
+    }
+    valoresAdversario = valores;
+    gasAdversario = n;
+    solidosAdversario = 0;
+    candidatoAdversario = 0;
+
+    // Mesma preparação do quickSort do programa principal
+    Estatisticas stats = {0, 0, 0};
+    semearPivoAleatorio(sementePivos);
+    v->ordenar(indices, 0, n - 1, &stats);
+    *comparacoes = stats.comparacoes;
+    free(indices);
+    return valores;
+}
+
+// Função que monta a tabela acumulada da lei de Zipf sobre k valores
+double *tabelaZipf(int k, double s)
+{
+    double *acumulada = malloc(sizeof(double) * (size_t)k);
+    if (!acumulada)
+        return NULL;
+    double soma = 0;
+    for (int i = 0; i < k; i++)
+    {
+        soma += 1.0 / pow(i + 1, s);
+        acumulada[i] = soma;
+    }
+    for (int i = 0; i < k; i++)
+        acumulada[i] /= soma;
+    return acumulada;
+}
+
+// Função que sorteia um posto de Zipf (0 = o mais frequente) por busca binária
+int sortearZipf(Pcg32 *g, const double *acumulada, int k)
+{
+    double u = proximoReal(g);
+    int low = 0, high = k - 1;
+    while (low < high)
+    {
+        int mid = low + (high - low) / 2;
+        if (acumulada[mid] < u)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+    return low;
+}
+
+// Função que gera um array da distribuição direto na saída; retorna 0 em caso de erro
+int gerarArray(Saida *s, const Configuracao *cfg, Pcg32 *g, const double *zipf)
+{
+    int n = cfg->tamanho;
+    iniciarArrayTexto(s, n);
+    if (cfg->distribuicao == DIST_ANTIQSORT)
+    {
+        long long comparacoes = 0;
+        int *valores = gerarAntiqsort(n, cfg->vitima, cfg->sementePivos, &comparacoes);
+        if (!valores)
+            return 0;
+        for (int i = 0; i < n; i++)
+            emitirValor(s, valores[i], i == 0);
+        free(valores);
+        fprintf(stderr, "antiqsort contra %s: %lld comparações para n = %d\n", cfg->vitima, comparacoes, n);
+    }
+    else
+    {
+        for (int i = 0; i < n; i++)
+        {
+            int32_t valor;
+            switch (cfg->distribuicao)
+            {
+                case DIST_UNIFORME:
+                    valor = (int32_t)proximoPcg(g);
+                    break;
+                case DIST_ORDENADO:
+                    valor = i;
+                    break;
+                case DIST_REVERSO:
+                    valor = n - 1 - i;
+                    break;
+                // Sobe até o meio e desce de volta
+                case DIST_ORGAO:
+                    valor = i < (n + 1) / 2 ? i : n - 1 - i;
+                    break;
+                // Sequências crescentes 0..distintos-1 repetidas
+                case DIST_SERRA:
+                    valor = i % cfg->distintos;
+                    break;
+                case DIST_POUCOS:
+                    valor = (int32_t)proximoLimitado(g, (uint32_t)cfg->distintos);
+                    break;
+                default:
+                    valor = sortearZipf(g, zipf, cfg->distintos);
+            }
+            emitirValor(s, valor, i == 0);
+        }
+    }
+    terminarArrayTexto(s);
+    return 1;
+}
+
+// Função que lê as opções opcionais após os argumentos obrigatórios
+int lerOpcoes(int argc, char *argv[], Configuracao *cfg)
+{
+    for (int a = 4; a < argc; a++)
+    {
+        const char *opcao = argv[a];
+        if (strncmp(opcao, "--arrays=", 9) == 0 && atoi(opcao + 9) > 0) cfg->qtdArrays = atoi(opcao + 9);
+        else if (strncmp(opcao, "--semente=", 10) == 0 && opcao[10]) cfg->semente = strtoull(opcao + 10, NULL, 10);
+        else if (strcmp(opcao, "--formato=binario") == 0) cfg->binario = 1;
+        else if (strcmp(opcao, "--formato=texto") == 0) cfg->binario = 0;
+        else if (strncmp(opcao, "--distintos=", 12) == 0 && atoi(opcao + 12) > 0) cfg->distintos = atoi(opcao + 12);
+        else if (strncmp(opcao, "--expoente=", 11) == 0 && atof(opcao + 11) > 0) cfg->expoente = atof(opcao + 11);
+        else if (strncmp(opcao, "--vitima=", 9) == 0 && opcao[9]) cfg->vitima = opcao + 9;
+        else if (strncmp(opcao, "--semente-pivos=", 16) == 0 && opcao[16]) cfg->sementePivos = strtoull(opcao + 16, NULL, 10);
+        else
+        {
+            printf("Opção inválida: %s\n", opcao);
+            return 0;
+        }
+    }
+    return 1;
+}
+
+int main(int argc, char *argv[])
+{
+    // Verifica argumentos
+    if (argc < 4)
+    {
+        printf("Uso: %s <arquivo_saida> <distribuicao> <tamanho> [opções]\n", argv[0]);
+        printf("Distribuições: uniforme, ordenado, reverso, orgao (sobe e desce), serra (dentes 0..D-1),\n");
+        printf("        poucos (D valores distintos), zipf (D valores, frequência ~ 1/k^s),\n");
+        printf("        antiqsort (adversário de McIlroy contra um método do quicksort; custa o mesmo\n");
+        printf("        que a ordenação atacada e guarda 2n inteiros na memória)\n");
+        printf("Tamanho: elementos por array, de 0 a 2147483647 (formato int32 do quicksort)\n");
+        printf("Opções: --arrays=K (arrays no arquivo; padrão: 1)\n");
+        printf("        --semente=N (semente do gerador; padrão: 42)\n");
+        printf("        --formato=texto|binario (formato de entrada do quicksort; padrão: texto)\n");
+        printf("        --distintos=D (padrão: 16 em poucos, sqrt(n) em serra, min(n, 65536) em zipf)\n");
+        printf("        --expoente=s (expoente de zipf; padrão: 1.0)\n");
+        printf("        --vitima=HM (método atacado pelo antiqsort, como no --metodos do quicksort, sem VM)\n");
+        printf("        --semente-pivos=N (semente dos pivôs R da vítima; padrão: 42, a do quicksort)\n");
+        return 1;
+    }
+
+    Configuracao cfg = {-1, 0, 1, 42, 0, 0, 1.0, "HM", 42};
+    for (int d = 0; d < QTD_DISTRIBUICOES; d++)
+        if (strcmp(argv[2], nomesDistribuicoes[d]) == 0)
+            cfg.distribuicao = d;
+    char *fim;
+    long long tamanho = strtoll(argv[3], &fim, 10);
+    if (cfg.distribuicao < 0 || *fim || tamanho < 0 || tamanho > INT32_MAX)
+    {
+        printf("Distribuição ou tamanho inválido: %s %s\n", argv[2], argv[3]);
+        return 1;
+    }
+    cfg.tamanho = (int)tamanho;
+    if (!lerOpcoes(argc, argv, &cfg)) return 1;
+
+    // Valores distintos padrão de cada distribuição
+    if (cfg.distintos == 0)
+    {
+        if (cfg.distribuicao == DIST_POUCOS) cfg.distintos = 16;
+        else if (cfg.distribuicao == DIST_SERRA) cfg.distintos = raizInteira(cfg.tamanho);
+        else cfg.distintos = cfg.tamanho < 65536 ? cfg.tamanho : 65536;
+        if (cfg.distintos < 1) cfg.distintos = 1;
+    }
+
+    double *zipf = NULL;
+    if (cfg.distribuicao == DIST_ZIPF && !(zipf = tabelaZipf(cfg.distintos, cfg.expoente)))
+    {
+        fprintf(stderr, "Erro ao alocar a tabela de Zipf\n");
+        return 1;
+    }
+
+    Saida saida = {fopen(argv[1], "wb"), cfg.binario, malloc(TAM_BUFFER_SAIDA), 0};
+    if (!saida.arquivo || !saida.buffer)
+    {
+        printf("Erro ao abrir arquivo de saída!\n");
+        if (saida.arquivo) fclose(saida.arquivo);
+        free(saida.buffer);
+        free(zipf);
+        return 1;
+    }
+
+    // Um único gerador para todos os arrays: mesma semente, mesmo arquivo
+    Pcg32 gerador;
+    semearPcg(&gerador, cfg.semente);
+    escreverCabecalho(&saida, cfg.qtdArrays, cfg.tamanho);
+    int ok = 1;
+    for (int a = 0; ok && a < cfg.qtdArrays; a++)
+        ok = gerarArray(&saida, &cfg, &gerador, zipf);
+    descarregarSaida(&saida);
+    ok = ok && !ferror(saida.arquivo);
+    ok = (fclose(saida.arquivo) == 0) && ok;
+    free(saida.buffer);
+    free(zipf);
+    if (!ok)
+    {
+        fprintf(stderr, "Erro ao gerar %s\n", argv[1]);
+        return 1;
+    }
+    return 0;
+}
@@ -1,5 +1,13 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include "medicaoOrdenacao.h"
+
+// Contadores do modo de medição: comparações entre elementos e movimentações
+// (cada descida no heap e cada troca da raiz com o fim contam uma)
+long long comparacoes = 0, trocas = 0;
+// Avalia uma comparação entre elementos contando-a
+#define CONTAR(expr) (comparacoes++, (expr))
 
 void criarHeap(int *array, int i, int f)
 {
@@ -9,10 +17,11 @@ void criarHeap(int *array, int i, int f)
     while (j <= f)
     {
         if (j < f)
-            if (array[j] < array[j + 1])
+            if (CONTAR(array[j] < array[j + 1]))
                 j = j + 1;
-        if (aux < array[j])
+        if (CONTAR(aux < array[j]))
         {
+            trocas++;
             array[i] = array[j];
             i = j;
             j = 2 * i + 1;
@@ -30,6 +39,7 @@ void heapSort(int *array, int n)
         criarHeap(array, i, n - 1);
     for (i = n - 1; i >= 1; i--)
     {
+        trocas++;
         aux = array[0];
         array[0] = array[i];
         array[i] = aux;
@@ -37,8 +47,27 @@ void heapSort(int *array, int n)
     }
 }
 
+// Rotina do modo de medição (a única do programa)
+void ordenarMedido(int rotina, int *vetor, int *buffer, int n, void *contexto, ContagemMedida *contagem)
+{
+    (void)rotina;
+    (void)buffer;
+    (void)contexto;
+    comparacoes = trocas = 0;
+    heapSort(vetor, n);
+    contagem->comparacoes = comparacoes;
+    contagem->trocas = trocas;
+}
+
 int main(int argc, char *argv[])
 {
+    // Modo de medição: heapSort <arquivo_entrada>
+    if (argc >= 2)
+    {
+        const char *nomes[] = {"heapSort"};
+        return medirArquivo(argv[1], nomes, 1, -1, ordenarMedido, NULL);
+    }
+
     int array[] = {38, 27, 43, 3, 9, 82, 10};
 
     // Ordena com HeapSort
@@ -0,0 +1,134 @@
+#ifndef MEDICAO_ORDENACAO_H
+#define MEDICAO_ORDENACAO_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/*
+ * Modo de medição comum aos programas de ordenação simples (quickSort, heapSort,
+ * mergeSort), usado pelo benchmark.py.
+ *
+ * medirArquivo(caminho, nomes, qtdRotinas, escolhida, rotina, contexto) lê a
+ * entrada no formato do quicksort (quantidade de arrays e, para cada um, o
+ * tamanho seguido dos elementos). Cada array é ordenado por cada rotina, ou só
+ * pela escolhida (-1: todas), sobre uma cópia, e a ordenação é conferida. O
+ * resultado sai em CSV na saída padrão:
+ *   array,tamanho,rotina,comparacoes,trocas,ns,memoria_kb
+ * Contagens negativas significam "não se aplica" e saem vazias. memoria_kb é o
+ * pico de memória residente do processo até ali (VmHWM), vazio fora do Linux.
+ */
+
+// Contagens de uma ordenação medida (negativas: não se aplica)
+typedef struct
+{
+    long long comparacoes;
+    long long trocas;
+} ContagemMedida;
+
+// Rotina medida: ordena vetor[0, n) com a implementação de índice rotina e grava as
+// contagens; buffer tem n elementos livres para quem precisar de memória auxiliar
+typedef void (*RotinaMedida)(int rotina, int *vetor, int *buffer, int n, void *contexto, ContagemMedida *contagem);
+
+// Função para ler o próximo array de uma entrada no formato do quicksort
+// (tamanho seguido dos elementos); retorna NULL no fim ou em caso de erro
+static int *lerArray(FILE *arquivo, int *n)
+{
+    if (fscanf(arquivo, "%d", n) != 1 || *n < 0)
+        return NULL;
+    int *array = malloc(sizeof(int) * (*n > 0 ? *n : 1));
+    if (!array)
+        return NULL;
+    for (int i = 0; i < *n; i++)
+        if (fscanf(arquivo, "%d", &array[i]) != 1)
+        {
+            free(array);
+            return NULL;
+        }
+    return array;
+}
+
+// Função que retorna o tempo atual em nanossegundos
+static long long agoraNs(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+// Função que retorna o pico de memória residente do processo em KB (VmHWM de
+// /proc/self/status), ou -1 se não estiver disponível
+static long picoMemoriaKb(void)
+{
+    FILE *status = fopen("/proc/self/status", "r");
+    char linha[256];
+    long kb = -1;
+    if (!status)
+        return -1;
+    while (fgets(linha, sizeof(linha), status))
+        if (sscanf(linha, "VmHWM: %ld", &kb) == 1)
+            break;
+    fclose(status);
+    return kb;
+}
+
+// Função do modo de medição; retorna o status de saída do programa
+static int medirArquivo(const char *caminho, const char *const *nomes, int qtdRotinas, int escolhida,
+                        RotinaMedida rotina, void *contexto)
+{
+    FILE *arquivo = fopen(caminho, "r");
+    int qtdArrays;
+    if (!arquivo || fscanf(arquivo, "%d", &qtdArrays) != 1)
+    {
+        printf("Erro ao abrir arquivo de entrada!\n");
+        if (arquivo) fclose(arquivo);
+        return 1;
+    }
+
+    printf("array,tamanho,rotina,comparacoes,trocas,ns,memoria_kb\n");
+    for (int a = 0; a < qtdArrays; a++)
+    {
+        int n;
+        int *original = lerArray(arquivo, &n);
+        int *vetor = original ? malloc(sizeof(int) * (n > 0 ? n : 1)) : NULL;
+        int *buffer = vetor ? malloc(sizeof(int) * (n > 0 ? n : 1)) : NULL;
+        if (!buffer)
+        {
+            fprintf(stderr, "Erro ao ler o array %d\n", a);
+            free(original); free(vetor);
+            fclose(arquivo);
+            return 1;
+        }
+        for (int r = 0; r < qtdRotinas; r++)
+        {
+            if (escolhida >= 0 && r != escolhida)
+                continue;
+            memcpy(vetor, original, sizeof(int) * n);
+            ContagemMedida contagem = {-1, -1};
+            long long inicio = agoraNs();
+            rotina(r, vetor, buffer, n, contexto, &contagem);
+            long long ns = agoraNs() - inicio;
+            // Confere a ordenação
+            for (int i = 1; i < n; i++)
+                if (vetor[i - 1] > vetor[i])
+                {
+                    fprintf(stderr, "Resultado fora de ordem (%s).\n", nomes[r]);
+                    break;
+                }
+            printf("%d,%d,%s,", a, n, nomes[r]);
+            if (contagem.comparacoes >= 0) printf("%lld", contagem.comparacoes);
+            printf(",");
+            if (contagem.trocas >= 0) printf("%lld", contagem.trocas);
+            printf(",%lld,", ns);
+            long kb = picoMemoriaKb();
+            if (kb >= 0) printf("%ld", kb);
+            printf("\n");
+        }
+        free(original); free(vetor); free(buffer);
+    }
+    fclose(arquivo);
+    return 0;
+}
+
+#endif
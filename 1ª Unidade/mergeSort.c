@@ -1,7 +1,21 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include "mergeSortGenerico.h"
+#include "medicaoOrdenacao.h"
 
-// Procedimento para mesclar dois subarrays ordenados
+// Comparação de inteiros usada pelo merge sort genérico
+#define MENOR_INT(a, b) ((a) < (b))
+DEFINIR_MERGESORT(mergeSortInt, int, MENOR_INT)
+
+// Comparações entre elementos contadas no modo de medição
+long long comparacoes = 0;
+// Instância do merge sort genérico que conta as comparações; só sequencial, já que
+// o contador global não serve às threads da versão paralela
+#define MENOR_INT_CONTADO(a, b) (comparacoes++, (a) < (b))
+DEFINIR_MERGESORT_SEQUENCIAL(mergeSortIntContado, int, MENOR_INT_CONTADO)
+
+// Procedimento para mesclar dois subarrays ordenados (versão clássica, mantida para comparação)
 void merge(int *vetor, int inicio, int meio, int fim)
 {
     // Declara variáveis necessárias
@@ -15,13 +29,16 @@ void merge(int *vetor, int inicio, int meio, int fim)
     temp = (int*) malloc(tamanho * sizeof(int));
 
     // Verifica se a alocação foi bem-sucedida
-    if (temp != NULL) {
+    if (temp == NULL) {
+        fprintf(stderr, "Erro de alocação no merge.\n");
+        return;
+    } else {
         // Mescla os dois subarrays no array temporário
         for (i = 0; i < tamanho; i++) {
             // Verifica se ambos os subarrays ainda têm elementos
             if (!fim1 && !fim2) {
                 // Compara os elementos dos dois subarrays e insere o menor no array temporário
-                if (vetor[n1] < vetor[n2])
+                if (comparacoes++, vetor[n1] < vetor[n2])
                     temp[i] = vetor[n1++];
                 else
                     temp[i] = vetor[n2++];
@@ -43,8 +60,8 @@ void merge(int *vetor, int inicio, int meio, int fim)
     free(temp);
 }
 
-// Procedimento principal do Merge Sort
-void mergeSort(int *vetor, int inicio, int fim)
+// Procedimento principal do Merge Sort clássico (top-down, com alocação a cada mescla)
+void mergeSortClassico(int *vetor, int inicio, int fim)
 {
     // Verifica se o array tem mais de um elemento
     if (inicio < fim)
@@ -52,16 +69,118 @@ void mergeSort(int *vetor, int inicio, int fim)
         // Encontra o ponto médio para dividir o array
         int mid = inicio + (fim - inicio) / 2;
         // Ordena a primeira e a segunda metade
-        mergeSort(vetor, inicio, mid);
+        mergeSortClassico(vetor, inicio, mid);
         // Ordena a segunda metade
-        mergeSort(vetor, mid + 1, fim);
+        mergeSortClassico(vetor, mid + 1, fim);
         // Mescla as duas metades ordenadas
         merge(vetor, inicio, mid, fim);
     }
 }
 
-int main()
+// Procedimento Merge Sort usando o módulo genérico com um único buffer pré-alocado
+void mergeSort(int *vetor, int inicio, int fim)
 {
+    // Verifica se o array tem mais de um elemento
+    if (inicio >= fim) return;
+    int tamanho = fim - inicio + 1;
+    int *buffer = malloc(sizeof(int) * tamanho);
+    if (!buffer)
+    {
+        fprintf(stderr, "Erro de alocação no merge sort.\n");
+        return;
+    }
+    mergeSortInt(vetor + inicio, (size_t)tamanho, buffer);
+    free(buffer);
+}
+
+// Procedimento de microbenchmark: compara o merge sort clássico com o genérico
+void benchmark(int n, int threads)
+{
+    // Distribuições de entrada avaliadas
+    const char *nomes[] = {"aleatorio", "ordenado", "reverso", "quase ordenado"};
+    int *base = malloc(sizeof(int) * n);
+    int *vetor = malloc(sizeof(int) * n);
+    int *buffer = malloc(sizeof(int) * n);
+    if (!base || !vetor || !buffer)
+    {
+        fprintf(stderr, "Erro de alocação no benchmark.\n");
+        free(base); free(vetor); free(buffer);
+        return;
+    }
+
+    printf("%-16s %12s %12s %12s\n", "entrada", "classico(s)", "generico(s)", "paralelo(s)");
+    for (int d = 0; d < 4; d++)
+    {
+        // Gera a distribuição com semente fixa
+        srand(42);
+        for (int i = 0; i < n; i++)
+        {
+            if (d == 0) base[i] = rand();
+            else if (d == 1) base[i] = i;
+            else if (d == 2) base[i] = n - i;
+            else base[i] = (rand() % 100 == 0) ? rand() : i;
+        }
+
+        // Mede cada implementação sobre a mesma cópia da entrada
+        double tempos[3];
+        for (int impl = 0; impl < 3; impl++)
+        {
+            memcpy(vetor, base, sizeof(int) * n);
+            long long inicio = agoraNs();
+            if (impl == 0) mergeSortClassico(vetor, 0, n - 1);
+            else if (impl == 1) mergeSortInt(vetor, (size_t)n, buffer);
+            else mergeSortIntParalelo(vetor, (size_t)n, buffer, threads);
+            tempos[impl] = (agoraNs() - inicio) / 1e9;
+            // Confere a ordenação
+            for (int i = 1; i < n; i++)
+                if (vetor[i - 1] > vetor[i])
+                {
+                    fprintf(stderr, "Resultado fora de ordem (implementação %d).\n", impl);
+                    break;
+                }
+        }
+        printf("%-16s %12.4f %12.4f %12.4f\n", nomes[d], tempos[0], tempos[1], tempos[2]);
+    }
+    free(base); free(vetor); free(buffer);
+}
+
+// Rotina do modo de medição: clássico, genérico (contando comparações) e paralelo,
+// com o número de threads em contexto. Merge sort não faz trocas (campo vazio) e a
+// versão paralela não conta comparações
+void ordenarMedido(int rotina, int *vetor, int *buffer, int n, void *contexto, ContagemMedida *contagem)
+{
+    comparacoes = 0;
+    if (rotina == 0) mergeSortClassico(vetor, 0, n - 1);
+    else if (rotina == 1) mergeSortIntContado(vetor, (size_t)n, buffer);
+    else mergeSortIntParalelo(vetor, (size_t)n, buffer, *(int *)contexto);
+    if (rotina < 2) contagem->comparacoes = comparacoes;
+}
+
+int main(int argc, char *argv[])
+{
+    // Modo de benchmark: mergeSort --bench N [threads]
+    if (argc >= 3 && strcmp(argv[1], "--bench") == 0)
+    {
+        int n = atoi(argv[2]);
+        int threads = argc >= 4 ? atoi(argv[3]) : 4;
+        if (n <= 0 || threads <= 0) return 1;
+        benchmark(n, threads);
+        return 0;
+    }
+    // Modo de medição: mergeSort <arquivo_entrada> [classico|generico|paralelo] [threads]
+    if (argc >= 2)
+    {
+        int threads = argc >= 4 ? atoi(argv[3]) : 4;
+        if (threads <= 0) return 1;
+        const char *nomes[] = {"classico", "generico", "paralelo"};
+        int escolhida = -1;
+        for (int r = 0; argc >= 3 && r < 3; r++)
+            if (strcmp(argv[2], nomes[r]) == 0) escolhida = r;
+        // Nome desconhecido não seleciona nenhuma rotina
+        if (argc >= 3 && escolhida < 0) escolhida = 3;
+        return medirArquivo(argv[1], nomes, 3, escolhida, ordenarMedido, &threads);
+    }
+
     // Exemplo de uso do Merge Sort
     int arr[] = {38, 27, 43, 3, 9, 82, 10};
     // Calcula o tamanho do array
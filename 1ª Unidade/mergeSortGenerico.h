@@ -0,0 +1,301 @@
+#ifndef MERGESORT_GENERICO_H
+#define MERGESORT_GENERICO_H
+
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+/*
+ * Merge sort genérico, estável e sem alocação por chamada.
+ *
+ * DEFINIR_MERGESORT(NOME, TIPO, MENOR) gera, para o tipo indicado:
+ *   void NOME(TIPO *v, size_t n, TIPO *buffer);
+ *   void NOME##Paralelo(TIPO *v, size_t n, TIPO *buffer, int threads);
+ * onde buffer é um vetor pré-alocado de n elementos e MENOR(a, b) é uma
+ * expressão que diz se o valor a vem estritamente antes de b.
+ * DEFINIR_MERGESORT_SEQUENCIAL(NOME, TIPO, MENOR) gera só NOME, para instâncias
+ * que não podem rodar em várias threads (por exemplo, se MENOR conta comparações
+ * num contador global).
+ *
+ * A ordenação é bottom-up: blocos pequenos são ordenados por inserção e
+ * depois mesclados em passadas que alternam entre v e buffer. Pares de
+ * blocos já em ordem são apenas copiados, e a mescla entra em modo de
+ * galope quando um lado vence várias vezes seguidas.
+ */
+
+// Tamanho dos blocos ordenados por inserção antes da primeira mescla
+#define MERGESORT_CORTE_INSERCAO 32
+// Vitórias consecutivas de um lado que disparam o modo de galope
+#define MERGESORT_GALOPE 7
+// Abaixo desse tamanho a versão paralela executa a sequencial
+#define MERGESORT_MIN_PARALELO (1 << 15)
+
+#define DEFINIR_MERGESORT_SEQUENCIAL(NOME, TIPO, MENOR)                                        \
+                                                                                               \
+/* Ordena v[ini, fim) por inserção */                                                          \
+static void NOME##Insercao(TIPO *v, size_t ini, size_t fim)                                    \
+{                                                                                              \
+    for (size_t i = ini + 1; i < fim; i++)                                                     \
+    {                                                                                          \
+        TIPO chave = v[i];                                                                     \
+        size_t j = i;                                                                          \
+        while (j > ini && MENOR(chave, v[j - 1]))                                              \
+        {                                                                                      \
+            v[j] = v[j - 1];                                                                   \
+            j--;                                                                               \
+        }                                                                                      \
+        v[j] = chave;                                                                          \
+    }                                                                                          \
+}                                                                                              \
+                                                                                               \
+/* Primeiro índice de v[ini, fim) com x < v[i] (busca exponencial seguida de binária) */       \
+static size_t NOME##GalopeSuperior(const TIPO *v, size_t ini, size_t fim, TIPO x)              \
+{                                                                                              \
+    size_t ant = ini, pos = ini, passo = 1;                                                    \
+    while (pos < fim && !MENOR(x, v[pos]))                                                     \
+    {                                                                                          \
+        ant = pos + 1;                                                                         \
+        pos += passo;                                                                          \
+        passo <<= 1;                                                                           \
+    }                                                                                          \
+    if (pos > fim) pos = fim;                                                                  \
+    while (ant < pos)                                                                          \
+    {                                                                                          \
+        size_t mid = ant + (pos - ant) / 2;                                                    \
+        if (MENOR(x, v[mid])) pos = mid;                                                       \
+        else ant = mid + 1;                                                                    \
+    }                                                                                          \
+    return ant;                                                                                \
+}                                                                                              \
+                                                                                               \
+/* Primeiro índice de v[ini, fim) com v[i] >= x */                                             \
+static size_t NOME##GalopeInferior(const TIPO *v, size_t ini, size_t fim, TIPO x)              \
+{                                                                                              \
+    size_t ant = ini, pos = ini, passo = 1;                                                    \
+    while (pos < fim && MENOR(v[pos], x))                                                      \
+    {                                                                                          \
+        ant = pos + 1;                                                                         \
+        pos += passo;                                                                          \
+        passo <<= 1;                                                                           \
+    }                                                                                          \
+    if (pos > fim) pos = fim;                                                                  \
+    while (ant < pos)                                                                          \
+    {                                                                                          \
+        size_t mid = ant + (pos - ant) / 2;                                                    \
+        if (!MENOR(v[mid], x)) pos = mid;                                                      \
+        else ant = mid + 1;                                                                    \
+    }                                                                                          \
+    return ant;                                                                                \
+}                                                                                              \
+                                                                                               \
+/* Mescla a[0, na) e b[0, nb) em dst; em empates o elemento de a vem primeiro */               \
+static void NOME##MesclarFaixas(const TIPO *a, size_t na, const TIPO *b, size_t nb, TIPO *dst) \
+{                                                                                              \
+    /* Faixas já em ordem: cópia direta */                                                     \
+    if (na == 0 || nb == 0 || !MENOR(b[0], a[na - 1]))                                         \
+    {                                                                                          \
+        memcpy(dst, a, na * sizeof(TIPO));                                                     \
+        memcpy(dst + na, b, nb * sizeof(TIPO));                                                \
+        return;                                                                                \
+    }                                                                                          \
+    size_t i = 0, j = 0, k = 0;                                                                \
+    int ganhosA = 0, ganhosB = 0;                                                              \
+    while (i < na && j < nb)                                                                   \
+    {                                                                                          \
+        if (MENOR(b[j], a[i]))                                                                 \
+        {                                                                                      \
+            dst[k++] = b[j++];                                                                 \
+            ganhosB++;                                                                         \
+            ganhosA = 0;                                                                       \
+        } else                                                                                 \
+        {                                                                                      \
+            dst[k++] = a[i++];                                                                 \
+            ganhosA++;                                                                         \
+            ganhosB = 0;                                                                       \
+        }                                                                                      \
+        /* Um lado vem vencendo: copia em bloco tudo que ainda vem antes do outro */           \
+        if (ganhosA >= MERGESORT_GALOPE && j < nb)                                             \
+        {                                                                                      \
+            size_t lim = NOME##GalopeSuperior(a, i, na, b[j]);                                 \
+            memcpy(dst + k, a + i, (lim - i) * sizeof(TIPO));                                  \
+            k += lim - i;                                                                      \
+            i = lim;                                                                           \
+            ganhosA = 0;                                                                       \
+        } else if (ganhosB >= MERGESORT_GALOPE && i < na)                                      \
+        {                                                                                      \
+            size_t lim = NOME##GalopeInferior(b, j, nb, a[i]);                                 \
+            memcpy(dst + k, b + j, (lim - j) * sizeof(TIPO));                                  \
+            k += lim - j;                                                                      \
+            j = lim;                                                                           \
+            ganhosB = 0;                                                                       \
+        }                                                                                      \
+    }                                                                                          \
+    /* Copia o restante do lado que sobrou */                                                  \
+    memcpy(dst + k, a + i, (na - i) * sizeof(TIPO));                                           \
+    k += na - i;                                                                               \
+    memcpy(dst + k, b + j, (nb - j) * sizeof(TIPO));                                           \
+}                                                                                              \
+                                                                                               \
+/* Ordenação sequencial: buffer deve ter espaço para n elementos */                            \
+static void NOME(TIPO *v, size_t n, TIPO *buffer)                                              \
+{                                                                                              \
+    /* Blocos iniciais ordenados por inserção */                                               \
+    for (size_t ini = 0; ini < n; ini += MERGESORT_CORTE_INSERCAO)                             \
+        NOME##Insercao(v, ini, ini + MERGESORT_CORTE_INSERCAO < n ? ini + MERGESORT_CORTE_INSERCAO : n); \
+    /* Passadas de mescla alternando entre v e buffer */                                       \
+    TIPO *origem = v, *destino = buffer;                                                       \
+    for (size_t largura = MERGESORT_CORTE_INSERCAO; largura < n; largura *= 2)                 \
+    {                                                                                          \
+        for (size_t ini = 0; ini < n; ini += 2 * largura)                                      \
+        {                                                                                      \
+            size_t meio = ini + largura < n ? ini + largura : n;                               \
+            size_t fim = meio + largura < n ? meio + largura : n;                              \
+            NOME##MesclarFaixas(origem + ini, meio - ini, origem + meio, fim - meio, destino + ini); \
+        }                                                                                      \
+        TIPO *aux = origem;                                                                    \
+        origem = destino;                                                                      \
+        destino = aux;                                                                         \
+    }                                                                                          \
+    /* Garante o resultado em v */                                                             \
+    if (origem != v) memcpy(v, origem, n * sizeof(TIPO));                                      \
+}
+
+#define DEFINIR_MERGESORT(NOME, TIPO, MENOR)                                                   \
+DEFINIR_MERGESORT_SEQUENCIAL(NOME, TIPO, MENOR)                                                \
+                                                                                               \
+/* Posição de a na divisão estável da saída de índice k da mescla de a[0, na) e b[0, nb) */    \
+static size_t NOME##CoRanking(const TIPO *a, size_t na, const TIPO *b, size_t nb, size_t k)    \
+{                                                                                              \
+    size_t lo = k > nb ? k - nb : 0, hi = k < na ? k : na;                                     \
+    while (lo < hi)                                                                            \
+    {                                                                                          \
+        size_t i = lo + (hi - lo) / 2;                                                         \
+        if (MENOR(b[k - i - 1], a[i])) hi = i;                                                 \
+        else lo = i + 1;                                                                       \
+    }                                                                                          \
+    return lo;                                                                                 \
+}                                                                                              \
+                                                                                               \
+/* Estado compartilhado pelas threads da ordenação paralela */                                 \
+typedef struct                                                                                 \
+{                                                                                              \
+    TIPO *v;                                                                                   \
+    TIPO *buffer;                                                                              \
+    size_t n;                                                                                  \
+    int threads;                                                                               \
+    pthread_barrier_t barreira;                                                                \
+    /* Largada: as threads só começam depois de todas as criações tentadas */                  \
+    pthread_mutex_t trava;                                                                     \
+    pthread_cond_t sinal;                                                                      \
+    int aberto;                                                                                \
+} NOME##Compartilhado;                                                                         \
+                                                                                               \
+typedef struct                                                                                 \
+{                                                                                              \
+    NOME##Compartilhado *comp;                                                                 \
+    int id;                                                                                    \
+} NOME##Tarefa;                                                                                \
+                                                                                               \
+/* Cada passada é dividida em pedaços de saída; pares grandes são repartidos por co-ranking */ \
+static void *NOME##Trabalhador(void *arg)                                                      \
+{                                                                                              \
+    NOME##Tarefa *tarefa = arg;                                                                \
+    NOME##Compartilhado *comp = tarefa->comp;                                                  \
+    pthread_mutex_lock(&comp->trava);                                                          \
+    while (!comp->aberto) pthread_cond_wait(&comp->sinal, &comp->trava);                       \
+    pthread_mutex_unlock(&comp->trava);                                                        \
+    size_t n = comp->n, T = (size_t)comp->threads, id = (size_t)tarefa->id;                    \
+    size_t blocos = (n + MERGESORT_CORTE_INSERCAO - 1) / MERGESORT_CORTE_INSERCAO;             \
+    /* Blocos iniciais distribuídos entre as threads */                                        \
+    for (size_t b = id; b < blocos; b += T)                                                    \
+    {                                                                                          \
+        size_t ini = b * MERGESORT_CORTE_INSERCAO;                                             \
+        NOME##Insercao(comp->v, ini, ini + MERGESORT_CORTE_INSERCAO < n ? ini + MERGESORT_CORTE_INSERCAO : n); \
+    }                                                                                          \
+    pthread_barrier_wait(&comp->barreira);                                                     \
+                                                                                               \
+    TIPO *origem = comp->v, *destino = comp->buffer;                                           \
+    for (size_t largura = MERGESORT_CORTE_INSERCAO; largura < n; largura *= 2)                 \
+    {                                                                                          \
+        size_t pares = (n + 2 * largura - 1) / (2 * largura);                                  \
+        size_t pedacos = T > pares ? (T + pares - 1) / pares : 1;                              \
+        for (size_t t = id; t < pares * pedacos; t += T)                                       \
+        {                                                                                      \
+            size_t p = t / pedacos, q = t % pedacos;                                           \
+            size_t ini = p * 2 * largura;                                                      \
+            size_t meio = ini + largura < n ? ini + largura : n;                               \
+            size_t fim = meio + largura < n ? meio + largura : n;                              \
+            size_t na = meio - ini, nb = fim - meio, total = fim - ini;                        \
+            /* Faixa de saída deste pedaço e o ponto de corte correspondente em cada lado */   \
+            size_t kIni = total * q / pedacos, kFim = total * (q + 1) / pedacos;               \
+            size_t iIni = NOME##CoRanking(origem + ini, na, origem + meio, nb, kIni);          \
+            size_t iFim = NOME##CoRanking(origem + ini, na, origem + meio, nb, kFim);          \
+            NOME##MesclarFaixas(origem + ini + iIni, iFim - iIni,                              \
+                                origem + meio + (kIni - iIni), (kFim - iFim) - (kIni - iIni),  \
+                                destino + ini + kIni);                                         \
+        }                                                                                      \
+        pthread_barrier_wait(&comp->barreira);                                                 \
+        TIPO *aux = origem;                                                                    \
+        origem = destino;                                                                      \
+        destino = aux;                                                                         \
+    }                                                                                          \
+    /* Cópia final para v, também dividida entre as threads */                                 \
+    if (origem != comp->v)                                                                     \
+    {                                                                                          \
+        size_t ini = n * id / T, fim = n * (id + 1) / T;                                       \
+        memcpy(comp->v + ini, origem + ini, (fim - ini) * sizeof(TIPO));                       \
+    }                                                                                          \
+    return NULL;                                                                               \
+}                                                                                              \
+                                                                                               \
+/* Ordenação paralela: mesmas garantias da sequencial, usando até 'threads' threads */         \
+static void NOME##Paralelo(TIPO *v, size_t n, TIPO *buffer, int threads)                       \
+{                                                                                              \
+    if (threads <= 1 || n < MERGESORT_MIN_PARALELO)                                            \
+    {                                                                                          \
+        NOME(v, n, buffer);                                                                    \
+        return;                                                                                \
+    }                                                                                          \
+    NOME##Compartilhado comp;                                                                  \
+    comp.v = v;                                                                                \
+    comp.buffer = buffer;                                                                      \
+    comp.n = n;                                                                                \
+    NOME##Tarefa *tarefas = malloc(sizeof(NOME##Tarefa) * (size_t)threads);                    \
+    pthread_t *ids = malloc(sizeof(pthread_t) * (size_t)threads);                              \
+    if (!tarefas || !ids)                                                                      \
+    {                                                                                          \
+        free(tarefas);                                                                         \
+        free(ids);                                                                             \
+        NOME(v, n, buffer);                                                                    \
+        return;                                                                                \
+    }                                                                                          \
+    pthread_mutex_init(&comp.trava, NULL);                                                     \
+    pthread_cond_init(&comp.sinal, NULL);                                                      \
+    comp.aberto = 0;                                                                           \
+    for (int t = 0; t < threads; t++)                                                          \
+    {                                                                                          \
+        tarefas[t].comp = &comp;                                                               \
+        tarefas[t].id = t;                                                                     \
+    }                                                                                          \
+    /* Se uma criação falhar, o trabalho é dividido só entre as threads já criadas */          \
+    comp.threads = 1;                                                                          \
+    while (comp.threads < threads                                                              \
+           && pthread_create(&ids[comp.threads], NULL, NOME##Trabalhador,                      \
+                             &tarefas[comp.threads]) == 0)                                     \
+        comp.threads++;                                                                        \
+    pthread_barrier_init(&comp.barreira, NULL, (unsigned)comp.threads);                        \
+    pthread_mutex_lock(&comp.trava);                                                           \
+    comp.aberto = 1;                                                                           \
+    pthread_cond_broadcast(&comp.sinal);                                                       \
+    pthread_mutex_unlock(&comp.trava);                                                         \
+    NOME##Trabalhador(&tarefas[0]);                                                            \
+    for (int t = 1; t < comp.threads; t++)                                                     \
+        pthread_join(ids[t], NULL);                                                            \
+    pthread_barrier_destroy(&comp.barreira);                                                   \
+    pthread_mutex_destroy(&comp.trava);                                                        \
+    pthread_cond_destroy(&comp.sinal);                                                         \
+    free(tarefas);                                                                             \
+    free(ids);                                                                                 \
+}
+
+#endif
@@ -1,10 +1,18 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <math.h>
+#include <string.h>
+#include "medicaoOrdenacao.h"
+
+// Contadores do modo de medição (comparações entre elementos e trocas)
+long long comparacoes = 0, trocas = 0;
+// Avalia uma comparação entre elementos contando-a
+#define CONTAR(expr) (comparacoes++, (expr))
 
 // Procedimento para trocar dois elementos de posição
 void swap(int *a, int *b)
 {
+    trocas++;      // Conta a troca
     int temp = *a; // Armazena o valor de a em uma variável temporária
     *a = *b;       // Atribui o valor de b para a
     *b = temp;     // Atribui o valor temporário (original de a) para b
@@ -23,9 +31,9 @@ int mediana(int *array, int low, int mid, int high)
     int b = array[mid];
     int c = array[high];
 
-    if ((a <= b && b <= c) || (c <= b && b <= a))
+    if ((CONTAR(a <= b) && CONTAR(b <= c)) || (CONTAR(c <= b) && CONTAR(b <= a)))
         return mid;
-    else if ((b <= a && a <= c) || (c <= a && a <= b))
+    else if ((CONTAR(b <= a) && CONTAR(a <= c)) || (CONTAR(c <= a) && CONTAR(a <= b)))
         return low;
     else
         return high;
@@ -39,7 +47,7 @@ int lomuto(int *array, int low, int high, int pivotValue)
     int pivotIndex = low; // Inicializa o índice do pivô
     // Encontra o índice do pivô com base no valor do pivô
     for (int i = low; i <= high; i++) {
-        if (array[i] == pivotValue) {
+        if (CONTAR(array[i] == pivotValue)) {
             pivotIndex = i;
             break;
         }
@@ -50,7 +58,7 @@ int lomuto(int *array, int low, int high, int pivotValue)
     for(int i = low; i < high; i++)
     {
         // Se o elemento atual é menor ou igual ao pivô faz a troca
-        if(array[i] <= pivotValue)
+        if(CONTAR(array[i] <= pivotValue))
         {
             // Faz a troca de posição entre array[begin] com array[i]
             swap(&array[begin], &array[i]);
@@ -105,12 +113,12 @@ int hoare(int *array, int low, int high, int pivot)
         // Incrementa i até encontrar um elemento maior ou igual ao pivô
         do {
             i++;
-        } while(array[i] < pivot);
+        } while(CONTAR(array[i] < pivot));
 
         // Decrementa j até encontrar um elemento menor ou igual ao pivô
         do {
             j--;
-        } while(array[j] > pivot);
+        } while(CONTAR(array[j] > pivot));
 
         // Se os índices se cruzaram, retorna j
         if(i >= j)
@@ -194,8 +202,26 @@ void quickSort(int *array, int low, int high, int method)
     }
 }
 
-int main()
+// Rotina do modo de medição: os métodos 1..6 ficam nos índices 0..5
+void ordenarMedido(int rotina, int *vetor, int *buffer, int n, void *contexto, ContagemMedida *contagem)
+{
+    (void)buffer;
+    (void)contexto;
+    comparacoes = trocas = 0;
+    quickSort(vetor, 0, n - 1, rotina + 1);
+    contagem->comparacoes = comparacoes;
+    contagem->trocas = trocas;
+}
+
+int main(int argc, char *argv[])
 {
+    // Modo de medição: quickSort <arquivo_entrada> [método 1..6]
+    if (argc >= 2)
+    {
+        const char *nomes[] = {"LP", "LM", "LA", "HP", "HM", "HA"};
+        return medirArquivo(argv[1], nomes, 6, (argc >= 3 ? atoi(argv[2]) : 0) - 1, ordenarMedido, NULL);
+    }
+
     // Exemplo de uso do Quick Sort
     int arr1[] = {38, 27, 43, 3, 9, 82, 10};
     int arr2[] = {38, 27, 43, 3, 9, 82, 10};
@@ -0,0 +1,828 @@
+#ifndef QUICKSORT_GENERICO_H
+#define QUICKSORT_GENERICO_H
+
+#include <stdint.h>
+
+/*
+ * Quick sorts genéricos e instrumentados, especializados em tempo de compilação.
+ *
+ * DEFINIR_QUICKSORT_BASE(NOME, TIPO, MENOR, SEMENTE) gera as primitivas do tipo:
+ * troca e mediana de três contadas, as políticas de pivô (Fixo, Mediana,
+ * Aleatorio, Pcg, Ninther, Amostra, Medianas), os esquemas de partição (Lomuto,
+ * Hoare, Bloco, TresVias, DuploPivo) com seus passos NOME##Passo<Esquema>,
+ * qualquer política combinando com qualquer esquema, e o híbrido
+ *   void NOME##PD(TIPO *v, int low, int high, Estatisticas *stats);
+ * MENOR(a, b) diz se a vem estritamente antes de b e SEMENTE(x) converte um
+ * elemento em unsigned long long para o pivô "aleatório".
+ *
+ * DEFINIR_QUICKSORT_METODO(NOME, BASE, TIPO, ESQUEMA, POLITICA) fixa um esquema
+ * e uma política de pivô da base e gera
+ *   void NOME(TIPO *v, int low, int high, Estatisticas *stats);
+ * e o passo NOME##Passo. DEFINIR_QUICKSORT_DRIVER(NOME, TIPO, PASSO) gera só o
+ * laço para um passo qualquer com a assinatura de NOME##Passo.
+ *
+ * DEFINIR_QUICKSORT(NOME, TIPO, MENOR, SEMENTE) gera a base e os métodos LP, LM,
+ * LA, HP, HM, HA, BM, BA, TV e DP como NOME##LP etc., mais os de nome esquema
+ * (L, H, B, T, D de duplo pivô) seguido da política: R (Pcg), N (Ninther),
+ * S (Amostra de sqrt(n)) e D (Medianas, determinística), como NOME##HR ou
+ * NOME##DD. O híbrido PD não tem variantes: a escolha do pivô (mediana de três
+ * ou ninther pelo tamanho) faz parte da sua adaptação aos dados.
+ *
+ * Pcg usa um gerador por thread: semearPivoAleatorio(semente) antes de cada
+ * ordenação torna as contagens reprodutíveis.
+ *
+ * Os ordenadores recebem a faixa fechada [low, high], não contam a chamada da
+ * própria faixa (contada por quem a criou) e não usam recursão: escolha, pivô
+ * e partição são resolvidos na compilação, sem switch por chamada.
+ */
+
+// Estrutura para estatísticas
+typedef struct
+{
+    long long trocas;
+    long long chamadas;
+    // Comparações entre elementos (não entra no custo do ranking)
+    long long comparacoes;
+} Estatisticas;
+
+// Avalia uma comparação entre elementos contando-a nas estatísticas
+#define COMPARAR(expr, stats) ((stats)->comparacoes++, (expr))
+
+// Subfaixas que ainda precisam ser ordenadas após uma partição (até três)
+typedef struct
+{
+    int ini[3];
+    int fim[3];
+    int qtd;
+} Subfaixas;
+
+// Profundidade máxima da pilha explícita: continuando sempre na menor subfaixa e
+// empilhando as outras da maior para a menor, cada entrada acima de outra vem de
+// uma faixa de no máximo metade do tamanho, logo 2 * 31 entradas bastam para int
+#define MAX_PILHA 64
+// Tamanho dos blocos de deslocamentos da partição em blocos
+#define TAM_BLOCO 128
+// Faixas com até este tamanho vão para o insertion sort no método híbrido (PD)
+#define LIMIAR_INSERCAO 24
+// Acima deste tamanho o pivô do método híbrido é o ninther (mediana de medianas)
+#define LIMIAR_NINTHER 128
+// Máximo de deslocamentos do insertion sort parcial antes de desistir
+#define LIMITE_INSERCAO_PARCIAL 8
+// Abaixo deste tamanho a política de amostra usa a mediana de três
+#define LIMIAR_AMOSTRA 1024
+
+// Estado do gerador PCG32 do pivô aleatório (um por thread)
+static _Thread_local uint64_t estadoPivoAleatorio = 0x853C49E6748FEA9BULL;
+
+// Procedimento que reinicia o gerador do pivô aleatório da thread
+static inline void semearPivoAleatorio(uint64_t semente)
+{
+    estadoPivoAleatorio = semente * 6364136223846793005ULL + 1442695040888963407ULL;
+}
+
+// Função que sorteia 32 bits (PCG32 XSH RR)
+static inline uint32_t proximoPivoAleatorio(void)
+{
+    uint64_t x = estadoPivoAleatorio;
+    estadoPivoAleatorio = x * 6364136223846793005ULL + 1442695040888963407ULL;
+    uint32_t misturado = (uint32_t)(((x >> 18) ^ x) >> 27);
+    uint32_t rotacao = (uint32_t)(x >> 59);
+    return (misturado >> rotacao) | (misturado << ((32 - rotacao) & 31));
+}
+
+// Função que calcula a raiz quadrada inteira (piso) de n >= 0 pelo método de Newton
+static inline int raizInteira(int n)
+{
+    if (n < 2)
+        return n;
+    long long x = n, y = (x + 1) / 2;
+    while (y < x)
+    {
+        x = y;
+        y = (x + n / x) / 2;
+    }
+    return (int)x;
+}
+
+#define DEFINIR_QUICKSORT_BASE(NOME, TIPO, MENOR, SEMENTE)                                     \
+                                                                                               \
+/* Troca dois elementos contando a troca */                                                    \
+static inline void NOME##Trocar(TIPO *a, TIPO *b, Estatisticas *stats)                         \
+{                                                                                              \
+    stats->trocas++;                                                                           \
+    TIPO temp = *a;                                                                            \
+    *a = *b;                                                                                   \
+    *b = temp;                                                                                 \
+}                                                                                              \
+                                                                                               \
+/* Índice da mediana de três amostras tomadas nos quartis da faixa */                          \
+static inline int NOME##Mediana(TIPO *v, int low, int high, Estatisticas *stats)               \
+{                                                                                              \
+    int n = high - low + 1;                                                                    \
+    int idx1 = low + (n/4);                                                                    \
+    int idx2 = low + (n/2);                                                                    \
+    int idx3 = low + (3*n/4);                                                                  \
+    TIPO a = v[idx1], b = v[idx2], c = v[idx3];                                                \
+    if ((COMPARAR(!MENOR(b, a), stats) && COMPARAR(!MENOR(c, b), stats)) ||                    \
+        (COMPARAR(!MENOR(b, c), stats) && COMPARAR(!MENOR(a, b), stats)))                      \
+        return idx2;                                                                           \
+    else if ((COMPARAR(!MENOR(a, b), stats) && COMPARAR(!MENOR(c, a), stats)) ||               \
+             (COMPARAR(!MENOR(a, c), stats) && COMPARAR(!MENOR(b, a), stats)))                 \
+        return idx1;                                                                           \
+    else                                                                                       \
+        return idx3;                                                                           \
+}                                                                                              \
+                                                                                               \
+/* Políticas de pivô: índice escolhido, ou -1 para a posição padrão do esquema */              \
+static inline int NOME##PivoFixo(TIPO *v, int low, int high, Estatisticas *stats)              \
+{                                                                                              \
+    (void)v; (void)low; (void)high; (void)stats;                                               \
+    return -1;                                                                                 \
+}                                                                                              \
+static inline int NOME##PivoMediana(TIPO *v, int low, int high, Estatisticas *stats)           \
+{                                                                                              \
+    return NOME##Mediana(v, low, high, stats);                                                 \
+}                                                                                              \
+/* "Aleatório" derivado do primeiro elemento da faixa */                                       \
+static inline int NOME##PivoAleatorio(TIPO *v, int low, int high, Estatisticas *stats)         \
+{                                                                                              \
+    (void)stats;                                                                               \
+    return low + (int)(SEMENTE(v[low]) % (unsigned long long)(high - low + 1));                \
+}                                                                                              \
+                                                                                               \
+/* Lomuto com o pivô em v[high]; devolve a posição final do pivô */                            \
+static inline int NOME##Lomuto(TIPO *v, int low, int high, Estatisticas *stats)                \
+{                                                                                              \
+    TIPO pivo = v[high];                                                                       \
+    int i = low - 1;                                                                           \
+    /* Cada elemento antes do pivô é comparado uma vez */                                      \
+    stats->comparacoes += high - low;                                                          \
+    for (int j = low; j < high; j++)                                                           \
+        if (!MENOR(pivo, v[j]))                                                                \
+        {                                                                                      \
+            i++;                                                                               \
+            NOME##Trocar(&v[i], &v[j], stats);                                                 \
+        }                                                                                      \
+    NOME##Trocar(&v[i + 1], &v[high], stats);                                                  \
+    return i + 1;                                                                              \
+}                                                                                              \
+                                                                                               \
+/* Hoare com o pivô em v[low]; devolve o fim da metade esquerda */                             \
+static inline int NOME##Hoare(TIPO *v, int low, int high, Estatisticas *stats)                 \
+{                                                                                              \
+    TIPO pivo = v[low];                                                                        \
+    int i = low - 1;                                                                           \
+    int j = high + 1;                                                                          \
+    while (1)                                                                                  \
+    {                                                                                          \
+        do {                                                                                   \
+            i++;                                                                               \
+        } while (COMPARAR(MENOR(v[i], pivo), stats));                                          \
+        do {                                                                                   \
+            j--;                                                                               \
+        } while (COMPARAR(MENOR(pivo, v[j]), stats));                                          \
+        if (i >= j)                                                                            \
+            return j;                                                                          \
+        NOME##Trocar(&v[i], &v[j], stats);                                                     \
+    }                                                                                          \
+}                                                                                              \
+                                                                                               \
+/* Partição em blocos (BlockQuicksort) com o pivô em v[low]: as comparações só     */          \
+/* gravam deslocamentos e as trocas são feitas em lote, sem desvios dependentes    */          \
+/* dos dados; o resto (até dois blocos) termina numa varredura de Hoare. Devolve a */          \
+/* posição final do pivô                                                            */         \
+static inline int NOME##Bloco(TIPO *v, int low, int high, Estatisticas *stats)                 \
+{                                                                                              \
+    TIPO pivo = v[low];                                                                        \
+    unsigned char deslocEsq[TAM_BLOCO], deslocDir[TAM_BLOCO];                                  \
+    int numEsq = 0, numDir = 0, iniEsq = 0, iniDir = 0;                                        \
+    int esq = low + 1, dir = high;                                                             \
+                                                                                               \
+    while (dir - esq + 1 > 2 * TAM_BLOCO)                                                      \
+    {                                                                                          \
+        /* Bloco da esquerda: marca os elementos >= pivô */                                    \
+        if (numEsq == 0)                                                                       \
+        {                                                                                      \
+            iniEsq = 0;                                                                        \
+            for (int j = 0; j < TAM_BLOCO; j++)                                                \
+            {                                                                                  \
+                deslocEsq[numEsq] = (unsigned char)j;                                          \
+                numEsq += !MENOR(v[esq + j], pivo);                                            \
+            }                                                                                  \
+            stats->comparacoes += TAM_BLOCO;                                                   \
+        }                                                                                      \
+        /* Bloco da direita: marca os elementos <= pivô */                                     \
+        if (numDir == 0)                                                                       \
+        {                                                                                      \
+            iniDir = 0;                                                                        \
+            for (int j = 0; j < TAM_BLOCO; j++)                                                \
+            {                                                                                  \
+                deslocDir[numDir] = (unsigned char)j;                                          \
+                numDir += !MENOR(pivo, v[dir - j]);                                            \
+            }                                                                                  \
+            stats->comparacoes += TAM_BLOCO;                                                   \
+        }                                                                                      \
+                                                                                               \
+        /* Troca em lote os pares fora de lugar (uma troca por par) */                         \
+        int num = numEsq < numDir ? numEsq : numDir;                                           \
+        for (int k = 0; k < num; k++)                                                          \
+        {                                                                                      \
+            TIPO *a = &v[esq + deslocEsq[iniEsq + k]];                                         \
+            TIPO *b = &v[dir - deslocDir[iniDir + k]];                                         \
+            TIPO temp = *a;                                                                    \
+            *a = *b;                                                                           \
+            *b = temp;                                                                         \
+        }                                                                                      \
+        stats->trocas += num;                                                                  \
+        numEsq -= num;                                                                         \
+        numDir -= num;                                                                         \
+        iniEsq += num;                                                                         \
+        iniDir += num;                                                                         \
+                                                                                               \
+        if (numEsq == 0) esq += TAM_BLOCO;                                                     \
+        if (numDir == 0) dir -= TAM_BLOCO;                                                     \
+    }                                                                                          \
+                                                                                               \
+    /* Resto com os mesmos critérios; deslocamentos pendentes são descartados */               \
+    while (1)                                                                                  \
+    {                                                                                          \
+        while (esq <= dir && COMPARAR(MENOR(v[esq], pivo), stats))                             \
+            esq++;                                                                             \
+        while (esq <= dir && COMPARAR(MENOR(pivo, v[dir]), stats))                             \
+            dir--;                                                                             \
+        if (esq >= dir)                                                                        \
+            break;                                                                             \
+        NOME##Trocar(&v[esq], &v[dir], stats);                                                 \
+        esq++;                                                                                 \
+        dir--;                                                                                 \
+    }                                                                                          \
+                                                                                               \
+    NOME##Trocar(&v[low], &v[dir], stats);                                                     \
+    return dir;                                                                                \
+}                                                                                              \
+                                                                                               \
+/* Três vias (bandeira holandesa) com o pivô v[p]: < | == | >; devolve só as faixas */         \
+/* dos menores e dos maiores, pulando as chaves iguais ao pivô                        */       \
+static inline void NOME##TresVias(TIPO *v, int low, int high,                                  \
+                                  int p, Subfaixas *sub, Estatisticas *stats)                  \
+{                                                                                              \
+    TIPO pivo = v[p];                                                                          \
+    int lt = low, i = low, gt = high;                                                          \
+    while (i <= gt)                                                                            \
+    {                                                                                          \
+        if (COMPARAR(MENOR(v[i], pivo), stats))                                                \
+        {                                                                                      \
+            NOME##Trocar(&v[lt], &v[i], stats);                                                \
+            lt++;                                                                              \
+            i++;                                                                               \
+        }                                                                                      \
+        else if (COMPARAR(MENOR(pivo, v[i]), stats))                                           \
+        {                                                                                      \
+            NOME##Trocar(&v[i], &v[gt], stats);                                                \
+            gt--;                                                                              \
+        }                                                                                      \
+        else                                                                                   \
+            i++;                                                                               \
+    }                                                                                          \
+    sub->ini[0] = low;                                                                         \
+    sub->fim[0] = lt - 1;                                                                      \
+    sub->ini[1] = gt + 1;                                                                      \
+    sub->fim[1] = high;                                                                        \
+    sub->qtd = 2;                                                                              \
+}                                                                                              \
+                                                                                               \
+/* Dois pivôs (Yaroslavskiy) com os pivôs em v[low] e v[high]: < p | p..q | > q; */            \
+/* se p == q a região do meio só tem chaves iguais e não é devolvida              */           \
+static inline void NOME##DuploPivo(TIPO *v, int low, int high,                                 \
+                                   Subfaixas *sub, Estatisticas *stats)                        \
+{                                                                                              \
+    if (COMPARAR(MENOR(v[high], v[low]), stats))                                               \
+        NOME##Trocar(&v[low], &v[high], stats);                                                \
+    TIPO p = v[low], q = v[high];                                                              \
+                                                                                               \
+    int l = low + 1, g = high - 1, k = l;                                                      \
+    while (k <= g)                                                                             \
+    {                                                                                          \
+        if (COMPARAR(MENOR(v[k], p), stats))                                                   \
+        {                                                                                      \
+            NOME##Trocar(&v[k], &v[l], stats);                                                 \
+            l++;                                                                               \
+        }                                                                                      \
+        else if (COMPARAR(MENOR(q, v[k]), stats))                                              \
+        {                                                                                      \
+            while (COMPARAR(MENOR(q, v[g]), stats) && k < g)                                   \
+                g--;                                                                           \
+            NOME##Trocar(&v[k], &v[g], stats);                                                 \
+            g--;                                                                               \
+            if (COMPARAR(MENOR(v[k], p), stats))                                               \
+            {                                                                                  \
+                NOME##Trocar(&v[k], &v[l], stats);                                             \
+                l++;                                                                           \
+            }                                                                                  \
+        }                                                                                      \
+        k++;                                                                                   \
+    }                                                                                          \
+                                                                                               \
+    l--;                                                                                       \
+    g++;                                                                                       \
+    NOME##Trocar(&v[low], &v[l], stats);                                                       \
+    NOME##Trocar(&v[high], &v[g], stats);                                                      \
+                                                                                               \
+    sub->ini[0] = low;                                                                         \
+    sub->fim[0] = l - 1;                                                                       \
+    sub->ini[1] = g + 1;                                                                       \
+    sub->fim[1] = high;                                                                        \
+    sub->qtd = 2;                                                                              \
+    if (MENOR(p, q))                                                                           \
+    {                                                                                          \
+        sub->ini[2] = l + 1;                                                                   \
+        sub->fim[2] = g - 1;                                                                   \
+        sub->qtd = 3;                                                                          \
+    }                                                                                          \
+}                                                                                              \
+                                                                                               \
+/* Pivôs do duplo pivô: elementos nos tercis, movidos para as pontas */                        \
+static inline void NOME##PivosTercis(TIPO *v, int low, int high, Estatisticas *stats)          \
+{                                                                                              \
+    int terco = (high - low + 1) / 3;                                                          \
+    NOME##Trocar(&v[low], &v[low + terco], stats);                                             \
+    NOME##Trocar(&v[high], &v[high - terco], stats);                                           \
+}                                                                                              \
+                                                                                               \
+/* Ordena três posições (a <= b <= c) */                                                       \
+static inline void NOME##OrdenarTres(TIPO *v, int a, int b, int c, Estatisticas *stats)        \
+{                                                                                              \
+    if (COMPARAR(MENOR(v[b], v[a]), stats)) NOME##Trocar(&v[a], &v[b], stats);                 \
+    if (COMPARAR(MENOR(v[c], v[b]), stats)) NOME##Trocar(&v[b], &v[c], stats);                 \
+    if (COMPARAR(MENOR(v[b], v[a]), stats)) NOME##Trocar(&v[a], &v[b], stats);                 \
+}                                                                                              \
+                                                                                               \
+/* Insertion sort em [low, high]; cada deslocamento conta uma troca. Com limite > 0, */        \
+/* desiste (devolve 0) ao passar de limite deslocamentos                              */       \
+static inline int NOME##Insercao(TIPO *v, int low, int high, int limite, Estatisticas *stats)  \
+{                                                                                              \
+    int deslocamentos = 0;                                                                     \
+    for (int i = low + 1; i <= high; i++)                                                      \
+    {                                                                                          \
+        TIPO chave = v[i];                                                                     \
+        int j = i - 1;                                                                         \
+        while (j >= low && COMPARAR(MENOR(chave, v[j]), stats))                                \
+        {                                                                                      \
+            v[j + 1] = v[j];                                                                   \
+            stats->trocas++;                                                                   \
+            j--;                                                                               \
+        }                                                                                      \
+        v[j + 1] = chave;                                                                      \
+        deslocamentos += i - 1 - j;                                                            \
+        if (limite > 0 && deslocamentos > limite)                                              \
+            return 0;                                                                          \
+    }                                                                                          \
+    return 1;                                                                                  \
+}                                                                                              \
+                                                                                               \
+/* Desce o elemento i no heap de máximo que começa em base e termina em base + f */            \
+static inline void NOME##CriarHeap(TIPO *v, int base, int i, int f, Estatisticas *stats)       \
+{                                                                                              \
+    int j = 2 * i + 1;                                                                         \
+    while (j <= f)                                                                             \
+    {                                                                                          \
+        if (j < f && COMPARAR(MENOR(v[base + j], v[base + j + 1]), stats))                     \
+            j++;                                                                               \
+        if (!COMPARAR(MENOR(v[base + i], v[base + j]), stats))                                 \
+            break;                                                                             \
+        NOME##Trocar(&v[base + i], &v[base + j], stats);                                       \
+        i = j;                                                                                 \
+        j = 2 * i + 1;                                                                         \
+    }                                                                                          \
+}                                                                                              \
+                                                                                               \
+/* Heap sort em [low, high] (fallback de profundidade do PD) */                                \
+static inline void NOME##HeapSort(TIPO *v, int low, int high, Estatisticas *stats)             \
+{                                                                                              \
+    int n = high - low + 1;                                                                    \
+    for (int i = (n - 2) / 2; i >= 0; i--)                                                     \
+        NOME##CriarHeap(v, low, i, n - 1, stats);                                              \
+    for (int i = n - 1; i >= 1; i--)                                                           \
+    {                                                                                          \
+        NOME##Trocar(&v[low], &v[low + i], stats);                                             \
+        NOME##CriarHeap(v, low, 0, i - 1, stats);                                              \
+    }                                                                                          \
+}                                                                                              \
+                                                                                               \
+/* Partição do PD com o pivô em v[low]: < | >=; indica se já estava particionada */            \
+static inline int NOME##ParticaoDireita(TIPO *v, int low, int high,                            \
+                                        int *jaParticionado, Estatisticas *stats)              \
+{                                                                                              \
+    TIPO pivo = v[low];                                                                        \
+    int i = low, j = high + 1;                                                                 \
+                                                                                               \
+    /* A escolha do pivô garante um elemento >= pivô à direita */                              \
+    do i++; while (COMPARAR(MENOR(v[i], pivo), stats));                                        \
+    /* Sem nenhum menor no início não há sentinela: a busca é limitada por i */                \
+    if (i - 1 == low)                                                                          \
+    {                                                                                          \
+        while (i < j)                                                                          \
+        {                                                                                      \
+            j--;                                                                               \
+            if (COMPARAR(MENOR(v[j], pivo), stats))                                            \
+                break;                                                                         \
+        }                                                                                      \
+    }                                                                                          \
+    else                                                                                       \
+        do j--; while (!COMPARAR(MENOR(v[j], pivo), stats));                                   \
+                                                                                               \
+    *jaParticionado = i >= j;                                                                  \
+    while (i < j)                                                                              \
+    {                                                                                          \
+        NOME##Trocar(&v[i], &v[j], stats);                                                     \
+        do i++; while (COMPARAR(MENOR(v[i], pivo), stats));                                    \
+        do j--; while (!COMPARAR(MENOR(v[j], pivo), stats));                                   \
+    }                                                                                          \
+                                                                                               \
+    NOME##Trocar(&v[low], &v[i - 1], stats);                                                   \
+    return i - 1;                                                                              \
+}                                                                                              \
+                                                                                               \
+/* Partição do PD para chaves repetidas: <= | >; a parte esquerda só tem iguais */             \
+static inline int NOME##ParticaoEsquerda(TIPO *v, int low, int high, Estatisticas *stats)      \
+{                                                                                              \
+    TIPO pivo = v[low];                                                                        \
+    int i = low, j = high + 1;                                                                 \
+                                                                                               \
+    /* v[low] == pivô serve de sentinela para a busca da direita */                            \
+    do j--; while (COMPARAR(MENOR(pivo, v[j]), stats));                                        \
+    if (j == high)                                                                             \
+    {                                                                                          \
+        while (i < j)                                                                          \
+        {                                                                                      \
+            i++;                                                                               \
+            if (COMPARAR(MENOR(pivo, v[i]), stats))                                            \
+                break;                                                                         \
+        }                                                                                      \
+    }                                                                                          \
+    else                                                                                       \
+        do i++; while (!COMPARAR(MENOR(pivo, v[i]), stats));                                   \
+                                                                                               \
+    while (i < j)                                                                              \
+    {                                                                                          \
+        NOME##Trocar(&v[i], &v[j], stats);                                                     \
+        do j--; while (COMPARAR(MENOR(pivo, v[j]), stats));                                    \
+        do i++; while (!COMPARAR(MENOR(pivo, v[i]), stats));                                   \
+    }                                                                                          \
+                                                                                               \
+    NOME##Trocar(&v[low], &v[j], stats);                                                       \
+    return j;                                                                                  \
+}                                                                                              \
+                                                                                               \
+/* Híbrido introsort/pdqsort (PD): insertion sort em faixas pequenas, pivô mediana */          \
+/* de três ou ninther, heap sort após 2*log2(n) níveis e insertion sort parcial    */          \
+/* nas faixas que já estavam particionadas. chamadas conta cada faixa visitada     */          \
+static void NOME##PD(TIPO *v, int low, int high, Estatisticas *stats)                          \
+{                                                                                              \
+    /* Pilha: início, fim, profundidade restante e se é a faixa mais à esquerda */             \
+    int pilha[MAX_PILHA][4];                                                                   \
+    int topo = 0;                                                                              \
+    int n = high - low + 1;                                                                    \
+    int limite = 0;                                                                            \
+    while (n > 1)                                                                              \
+    {                                                                                          \
+        limite += 2;                                                                           \
+        n >>= 1;                                                                               \
+    }                                                                                          \
+    int maisEsquerda = 1;                                                                      \
+                                                                                               \
+    while (1)                                                                                  \
+    {                                                                                          \
+        while (1)                                                                              \
+        {                                                                                      \
+            int tamanho = high - low + 1;                                                      \
+            if (tamanho <= LIMIAR_INSERCAO)                                                    \
+            {                                                                                  \
+                if (tamanho > 1)                                                               \
+                    NOME##Insercao(v, low, high, 0, stats);                                    \
+                break;                                                                         \
+            }                                                                                  \
+            if (limite == 0)                                                                   \
+            {                                                                                  \
+                NOME##HeapSort(v, low, high, stats);                                           \
+                break;                                                                         \
+            }                                                                                  \
+            limite--;                                                                          \
+                                                                                               \
+            /* Pivô em v[low]: ninther nas faixas grandes, senão mediana de três */            \
+            int meio = low + tamanho / 2;                                                      \
+            if (tamanho > LIMIAR_NINTHER)                                                      \
+            {                                                                                  \
+                NOME##OrdenarTres(v, low, meio, high, stats);                                  \
+                NOME##OrdenarTres(v, low + 1, meio - 1, high - 1, stats);                      \
+                NOME##OrdenarTres(v, low + 2, meio + 1, high - 2, stats);                      \
+                NOME##OrdenarTres(v, meio - 1, meio, meio + 1, stats);                         \
+                NOME##Trocar(&v[low], &v[meio], stats);                                        \
+            } else                                                                             \
+                NOME##OrdenarTres(v, meio, low, high, stats);                                  \
+                                                                                               \
+            /* Pivô igual ao anterior: separa as chaves iguais e segue com os maiores */       \
+            if (!maisEsquerda && !COMPARAR(MENOR(v[low - 1], v[low]), stats))                  \
+            {                                                                                  \
+                low = NOME##ParticaoEsquerda(v, low, high, stats) + 1;                         \
+                stats->chamadas++;                                                             \
+                continue;                                                                      \
+            }                                                                                  \
+                                                                                               \
+            int jaParticionado;                                                                \
+            int pos = NOME##ParticaoDireita(v, low, high, &jaParticionado, stats);             \
+            stats->chamadas += 2;                                                              \
+                                                                                               \
+            /* Faixa já particionada: tenta terminar as duas metades por inserção */           \
+            if (jaParticionado &&                                                              \
+                NOME##Insercao(v, low, pos - 1, LIMITE_INSERCAO_PARCIAL, stats) &&             \
+                NOME##Insercao(v, pos + 1, high, LIMITE_INSERCAO_PARCIAL, stats))              \
+                break;                                                                         \
+                                                                                               \
+            if (pos - low < high - pos)                                                        \
+            {                                                                                  \
+                pilha[topo][0] = pos + 1;                                                      \
+                pilha[topo][1] = high;                                                         \
+                pilha[topo][2] = limite;                                                       \
+                pilha[topo][3] = 0;                                                            \
+                high = pos - 1;                                                                \
+            } else                                                                             \
+            {                                                                                  \
+                pilha[topo][0] = low;                                                          \
+                pilha[topo][1] = pos - 1;                                                      \
+                pilha[topo][2] = limite;                                                       \
+                pilha[topo][3] = maisEsquerda;                                                 \
+                low = pos + 1;                                                                 \
+                maisEsquerda = 0;                                                              \
+            }                                                                                  \
+            topo++;                                                                            \
+        }                                                                                      \
+                                                                                               \
+        if (topo == 0)                                                                         \
+            break;                                                                             \
+        topo--;                                                                                \
+        low = pilha[topo][0];                                                                  \
+        high = pilha[topo][1];                                                                 \
+        limite = pilha[topo][2];                                                               \
+        maisEsquerda = pilha[topo][3];                                                         \
+    }                                                                                          \
+}                                                                                              \
+                                                                                               \
+/* Índice da mediana de v[a], v[b] e v[c] */                                                   \
+static inline int NOME##MedianaTres(TIPO *v, int a, int b, int c, Estatisticas *stats)         \
+{                                                                                              \
+    if (COMPARAR(MENOR(v[a], v[b]), stats))                                                    \
+    {                                                                                          \
+        if (COMPARAR(MENOR(v[b], v[c]), stats))                                                \
+            return b;                                                                          \
+        return COMPARAR(MENOR(v[a], v[c]), stats) ? c : a;                                     \
+    }                                                                                          \
+    if (COMPARAR(MENOR(v[a], v[c]), stats))                                                    \
+        return a;                                                                              \
+    return COMPARAR(MENOR(v[b], v[c]), stats) ? c : b;                                         \
+}                                                                                              \
+                                                                                               \
+/* Seleção (quickselect em três vias): deixa em v[alvo] o elemento que ocuparia */             \
+/* essa posição se [low, high] estivesse ordenada                                */            \
+static inline void NOME##Selecionar(TIPO *v, int low, int high, int alvo, Estatisticas *stats) \
+{                                                                                              \
+    while (high - low > LIMIAR_INSERCAO)                                                       \
+    {                                                                                          \
+        Subfaixas sub;                                                                         \
+        int p = NOME##MedianaTres(v, low, low + (high - low) / 2, high, stats);                \
+        NOME##TresVias(v, low, high, p, &sub, stats);                                          \
+        if (alvo <= sub.fim[0])                                                                \
+            high = sub.fim[0];                                                                 \
+        else if (alvo >= sub.ini[1])                                                           \
+            low = sub.ini[1];                                                                  \
+        else                                                                                   \
+            return;                                                                            \
+    }                                                                                          \
+    NOME##Insercao(v, low, high, 0, stats);                                                    \
+}                                                                                              \
+                                                                                               \
+/* Seleção determinística em tempo linear (BFPRT): o pivô de cada rodada é a      */           \
+/* mediana das medianas dos grupos de 5, achada recursivamente (profundidade log n) */         \
+static inline void NOME##SelecionarMedianas(TIPO *v, int low, int high, int alvo,              \
+                                            Estatisticas *stats)                               \
+{                                                                                              \
+    while (high - low > 10)                                                                    \
+    {                                                                                          \
+        /* Ordena cada grupo de 5 e leva sua mediana para o início da faixa */                 \
+        int grupos = 0;                                                                        \
+        for (int g = low; g + 4 <= high; g += 5)                                               \
+        {                                                                                      \
+            NOME##Insercao(v, g, g + 4, 0, stats);                                             \
+            NOME##Trocar(&v[low + grupos], &v[g + 2], stats);                                  \
+            grupos++;                                                                          \
+        }                                                                                      \
+        int meio = low + grupos / 2;                                                           \
+        NOME##SelecionarMedianas(v, low, low + grupos - 1, meio, stats);                       \
+                                                                                               \
+        /* Três vias em torno da mediana das medianas: cada lado tem <= 7n/10 */               \
+        Subfaixas sub;                                                                         \
+        NOME##TresVias(v, low, high, meio, &sub, stats);                                       \
+        if (alvo <= sub.fim[0])                                                                \
+            high = sub.fim[0];                                                                 \
+        else if (alvo >= sub.ini[1])                                                           \
+            low = sub.ini[1];                                                                  \
+        else                                                                                   \
+            return;                                                                            \
+    }                                                                                          \
+    NOME##Insercao(v, low, high, 0, stats);                                                    \
+}                                                                                              \
+                                                                                               \
+/* Aleatório de verdade: PCG32 semeado (semearPivoAleatorio), independente dos dados */        \
+static inline int NOME##PivoPcg(TIPO *v, int low, int high, Estatisticas *stats)               \
+{                                                                                              \
+    (void)v; (void)stats;                                                                      \
+    return low + (int)(((uint64_t)proximoPivoAleatorio() * (uint32_t)(high - low + 1)) >> 32); \
+}                                                                                              \
+                                                                                               \
+/* Ninther: mediana das medianas de três trincas espalhadas pela faixa */                      \
+static inline int NOME##PivoNinther(TIPO *v, int low, int high, Estatisticas *stats)           \
+{                                                                                              \
+    int n = high - low + 1;                                                                    \
+    if (n < LIMIAR_NINTHER)                                                                    \
+        return NOME##Mediana(v, low, high, stats);                                             \
+    int passo = (n - 1) / 8;                                                                   \
+    int m1 = NOME##MedianaTres(v, low, low + passo, low + 2 * passo, stats);                   \
+    int m2 = NOME##MedianaTres(v, low + 3 * passo, low + 4 * passo, low + 5 * passo, stats);   \
+    int m3 = NOME##MedianaTres(v, low + 6 * passo, low + 7 * passo, low + 8 * passo, stats);   \
+    return NOME##MedianaTres(v, m1, m2, m3, stats);                                            \
+}                                                                                              \
+                                                                                               \
+/* Mediana de uma amostra de ~sqrt(n) elementos espaçados, trazidos para o início */           \
+/* da faixa (com passo >= tamanho da amostra, nenhuma já trazida é movida de novo) */          \
+static inline int NOME##PivoAmostra(TIPO *v, int low, int high, Estatisticas *stats)           \
+{                                                                                              \
+    int n = high - low + 1;                                                                    \
+    if (n < LIMIAR_AMOSTRA)                                                                    \
+        return NOME##Mediana(v, low, high, stats);                                             \
+    int k = raizInteira(n);                                                                    \
+    k -= !(k & 1);                                                                             \
+    int passo = n / k;                                                                         \
+    for (int i = 1; i < k; i++)                                                                \
+        NOME##Trocar(&v[low + i], &v[low + i * passo], stats);                                 \
+    NOME##Selecionar(v, low, low + k - 1, low + k / 2, stats);                                 \
+    return low + k / 2;                                                                        \
+}                                                                                              \
+                                                                                               \
+/* Mediana exata da faixa por BFPRT: pivô ótimo e determinístico, a custo linear */            \
+static inline int NOME##PivoMedianas(TIPO *v, int low, int high, Estatisticas *stats)          \
+{                                                                                              \
+    int alvo = low + (high - low) / 2;                                                         \
+    NOME##SelecionarMedianas(v, low, high, alvo, stats);                                       \
+    return alvo;                                                                               \
+}                                                                                              \
+                                                                                               \
+/* Passos de partição, um por esquema, com o índice do pivô já escolhido pela */               \
+/* política (-1: posição padrão do esquema); deixam em sub as faixas restantes  */             \
+static inline void NOME##PassoLomuto(TIPO *v, int low, int high,                               \
+                                     int p, Subfaixas *sub, Estatisticas *stats)               \
+{                                                                                              \
+    if (p >= 0)                                                                                \
+        NOME##Trocar(&v[high], &v[p], stats);                                                  \
+    int mid = NOME##Lomuto(v, low, high, stats);                                               \
+    sub->ini[0] = low;                                                                         \
+    sub->fim[0] = mid - 1;                                                                     \
+    sub->ini[1] = mid + 1;                                                                     \
+    sub->fim[1] = high;                                                                        \
+    sub->qtd = 2;                                                                              \
+}                                                                                              \
+/* Hoare inclui mid na metade esquerda */                                                      \
+static inline void NOME##PassoHoare(TIPO *v, int low, int high,                                \
+                                    int p, Subfaixas *sub, Estatisticas *stats)                \
+{                                                                                              \
+    if (p >= 0)                                                                                \
+        NOME##Trocar(&v[low], &v[p], stats);                                                   \
+    int mid = NOME##Hoare(v, low, high, stats);                                                \
+    sub->ini[0] = low;                                                                         \
+    sub->fim[0] = mid;                                                                         \
+    sub->ini[1] = mid + 1;                                                                     \
+    sub->fim[1] = high;                                                                        \
+    sub->qtd = 2;                                                                              \
+}                                                                                              \
+static inline void NOME##PassoBloco(TIPO *v, int low, int high,                                \
+                                    int p, Subfaixas *sub, Estatisticas *stats)                \
+{                                                                                              \
+    if (p >= 0)                                                                                \
+        NOME##Trocar(&v[low], &v[p], stats);                                                   \
+    int mid = NOME##Bloco(v, low, high, stats);                                                \
+    sub->ini[0] = low;                                                                         \
+    sub->fim[0] = mid - 1;                                                                     \
+    sub->ini[1] = mid + 1;                                                                     \
+    sub->fim[1] = high;                                                                        \
+    sub->qtd = 2;                                                                              \
+}                                                                                              \
+static inline void NOME##PassoTresVias(TIPO *v, int low, int high,                             \
+                                       int p, Subfaixas *sub, Estatisticas *stats)             \
+{                                                                                              \
+    NOME##TresVias(v, low, high, p >= 0 ? p : low, sub, stats);                                \
+}                                                                                              \
+/* Duplo pivô: por padrão os pivôs são os tercis; senão o escolhido vai para v[low] */         \
+static inline void NOME##PassoDuploPivo(TIPO *v, int low, int high,                            \
+                                        int p, Subfaixas *sub, Estatisticas *stats)            \
+{                                                                                              \
+    if (p >= 0)                                                                                \
+    {                                                                                          \
+        NOME##Trocar(&v[low], &v[p], stats);                                                   \
+        NOME##Trocar(&v[high], &v[high - (high - low + 1) / 3], stats);                        \
+    } else                                                                                     \
+        NOME##PivosTercis(v, low, high, stats);                                                \
+    NOME##DuploPivo(v, low, high, sub, stats);                                                 \
+}
+
+#define DEFINIR_QUICKSORT_DRIVER(NOME, TIPO, PASSO)                                                \
+                                                                                                   \
+/* Laço com pilha explícita: continua na menor subfaixa (a última em caso de empate) */            \
+/* e empilha as outras; chamadas conta cada subfaixa criada, mesmo as vazias         */            \
+static void NOME(TIPO *v, int low, int high, Estatisticas *stats)                                  \
+{                                                                                                  \
+    int pilha[MAX_PILHA][2];                                                                       \
+    int topo = 0;                                                                                  \
+    while (1)                                                                                      \
+    {                                                                                              \
+        while (low < high)                                                                         \
+        {                                                                                          \
+            Subfaixas sub;                                                                         \
+            PASSO(v, low, high, &sub, stats);                                                      \
+            stats->chamadas += sub.qtd;                                                            \
+            int menor = 0;                                                                         \
+            for (int f = 1; f < sub.qtd; f++)                                                      \
+                if (sub.fim[f] - sub.ini[f] <= sub.fim[menor] - sub.ini[menor])                    \
+                    menor = f;                                                                     \
+            /* Das outras, a maior vai para o fundo: a de cima é retomada primeiro */              \
+            int outras[2], qtdOutras = 0;                                                          \
+            for (int f = 0; f < sub.qtd; f++)                                                      \
+                if (f != menor)                                                                    \
+                    outras[qtdOutras++] = f;                                                       \
+            if (qtdOutras == 2 &&                                                                  \
+                sub.fim[outras[0]] - sub.ini[outras[0]] < sub.fim[outras[1]] - sub.ini[outras[1]]) \
+            {                                                                                      \
+                int f = outras[0];                                                                 \
+                outras[0] = outras[1];                                                             \
+                outras[1] = f;                                                                     \
+            }                                                                                      \
+            for (int k = 0; k < qtdOutras; k++)                                                    \
+            {                                                                                      \
+                pilha[topo][0] = sub.ini[outras[k]];                                               \
+                pilha[topo][1] = sub.fim[outras[k]];                                               \
+                topo++;                                                                            \
+            }                                                                                      \
+            low = sub.ini[menor];                                                                  \
+            high = sub.fim[menor];                                                                 \
+        }                                                                                          \
+        if (topo == 0)                                                                             \
+            break;                                                                                 \
+        topo--;                                                                                    \
+        low = pilha[topo][0];                                                                      \
+        high = pilha[topo][1];                                                                     \
+    }                                                                                              \
+}
+
+#define DEFINIR_QUICKSORT_METODO(NOME, BASE, TIPO, ESQUEMA, POLITICA)                          \
+                                                                                               \
+/* Passo do método: política de pivô e esquema fixados na compilação */                        \
+static inline void NOME##Passo(TIPO *v, int low, int high,                                     \
+                               Subfaixas *sub, Estatisticas *stats)                            \
+{                                                                                              \
+    BASE##Passo##ESQUEMA(v, low, high, BASE##Pivo##POLITICA(v, low, high, stats), sub, stats); \
+}                                                                                              \
+DEFINIR_QUICKSORT_DRIVER(NOME, TIPO, NOME##Passo)
+
+#define DEFINIR_QUICKSORT(NOME, TIPO, MENOR, SEMENTE)                                          \
+                                                                                               \
+DEFINIR_QUICKSORT_BASE(NOME, TIPO, MENOR, SEMENTE)                                             \
+DEFINIR_QUICKSORT_METODO(NOME##LP, NOME, TIPO, Lomuto, Fixo)                                   \
+DEFINIR_QUICKSORT_METODO(NOME##LM, NOME, TIPO, Lomuto, Mediana)                                \
+DEFINIR_QUICKSORT_METODO(NOME##LA, NOME, TIPO, Lomuto, Aleatorio)                              \
+DEFINIR_QUICKSORT_METODO(NOME##HP, NOME, TIPO, Hoare, Fixo)                                    \
+DEFINIR_QUICKSORT_METODO(NOME##HM, NOME, TIPO, Hoare, Mediana)                                 \
+DEFINIR_QUICKSORT_METODO(NOME##HA, NOME, TIPO, Hoare, Aleatorio)                               \
+DEFINIR_QUICKSORT_METODO(NOME##BM, NOME, TIPO, Bloco, Mediana)                                 \
+DEFINIR_QUICKSORT_METODO(NOME##BA, NOME, TIPO, Bloco, Aleatorio)                               \
+DEFINIR_QUICKSORT_METODO(NOME##TV, NOME, TIPO, TresVias, Mediana)                              \
+DEFINIR_QUICKSORT_METODO(NOME##DP, NOME, TIPO, DuploPivo, Fixo)                                \
+DEFINIR_QUICKSORT_METODO(NOME##LR, NOME, TIPO, Lomuto, Pcg)                                    \
+DEFINIR_QUICKSORT_METODO(NOME##LN, NOME, TIPO, Lomuto, Ninther)                                \
+DEFINIR_QUICKSORT_METODO(NOME##LS, NOME, TIPO, Lomuto, Amostra)                                \
+DEFINIR_QUICKSORT_METODO(NOME##LD, NOME, TIPO, Lomuto, Medianas)                               \
+DEFINIR_QUICKSORT_METODO(NOME##HR, NOME, TIPO, Hoare, Pcg)                                     \
+DEFINIR_QUICKSORT_METODO(NOME##HN, NOME, TIPO, Hoare, Ninther)                                 \
+DEFINIR_QUICKSORT_METODO(NOME##HS, NOME, TIPO, Hoare, Amostra)                                 \
+DEFINIR_QUICKSORT_METODO(NOME##HD, NOME, TIPO, Hoare, Medianas)                                \
+DEFINIR_QUICKSORT_METODO(NOME##BR, NOME, TIPO, Bloco, Pcg)                                     \
+DEFINIR_QUICKSORT_METODO(NOME##BN, NOME, TIPO, Bloco, Ninther)                                 \
+DEFINIR_QUICKSORT_METODO(NOME##BS, NOME, TIPO, Bloco, Amostra)                                 \
+DEFINIR_QUICKSORT_METODO(NOME##BD, NOME, TIPO, Bloco, Medianas)                                \
+DEFINIR_QUICKSORT_METODO(NOME##TR, NOME, TIPO, TresVias, Pcg)                                  \
+DEFINIR_QUICKSORT_METODO(NOME##TN, NOME, TIPO, TresVias, Ninther)                              \
+DEFINIR_QUICKSORT_METODO(NOME##TS, NOME, TIPO, TresVias, Amostra)                              \
+DEFINIR_QUICKSORT_METODO(NOME##TD, NOME, TIPO, TresVias, Medianas)                            \
+DEFINIR_QUICKSORT_METODO(NOME##DR, NOME, TIPO, DuploPivo, Pcg)                                 \
+DEFINIR_QUICKSORT_METODO(NOME##DN, NOME, TIPO, DuploPivo, Ninther)                             \
+DEFINIR_QUICKSORT_METODO(NOME##DS, NOME, TIPO, DuploPivo, Amostra)                             \
+DEFINIR_QUICKSORT_METODO(NOME##DD, NOME, TIPO, DuploPivo, Medianas)
+
+#endif